@@ -37,6 +37,8 @@ constexpr auto min_cpu_cores = "1";
 constexpr auto default_memory_size = "1G";
 constexpr auto default_disk_size = "5G";
 constexpr auto default_cpu_cores = min_cpu_cores;
+constexpr auto default_disk_profile = "default";
+constexpr auto default_memory_profile = "default";
 constexpr auto default_timeout = std::chrono::seconds(300);
 constexpr auto image_resize_timeout = std::chrono::duration_cast<std::chrono::milliseconds>(5min).count();
 
@@ -60,6 +62,11 @@ constexpr auto bridged_interface_key = "local.bridged-network";       // idem
 constexpr auto mounts_key = "local.privileged-mounts";                // idem
 constexpr auto winterm_key = "client.apps.windows-terminal.profiles"; // idem
 constexpr auto mirror_key = "local.image.mirror";                     // idem; this defines the mirror of simple streams
+constexpr auto image_pool_key = "local.image.pool-size";              // idem
+constexpr auto ssh_profile_key = "local.ssh-profile";                 // idem
+constexpr auto qemu_suspend_mode_key = "local.qemu.suspend-mode";     // idem
+constexpr auto qemu_mount_driver_key = "local.qemu.mount-driver";     // idem
+constexpr auto qemu_overcommit_key = "local.qemu.memory-overcommit";  // idem
 
 [[maybe_unused]] // hands off clang-format
 constexpr auto key_examples = {petenv_key, driver_key, mounts_key};
@@ -20,6 +20,7 @@
 
 #include <libssh/libssh.h>
 
+#include <array>
 #include <chrono>
 #include <exception>
 #include <memory>
@@ -58,6 +59,12 @@ public:
     bool exit_recognized(std::chrono::milliseconds timeout = std::chrono::milliseconds(10)); // keeps session lock
     int exit_code(std::chrono::milliseconds timeout = std::chrono::seconds(5));              // releases session lock
 
+    // Wait up to the given timeout for the process to finish, moving any output received in the meantime into the
+    // given strings. Unlike exit_recognized(), this consumes output, which keeps chatty processes from stalling while
+    // their output is relayed. Returns whether the exit code is now known; keeps the session locked either way.
+    bool wait_for_output(std::chrono::milliseconds timeout, std::string& std_out, std::string& std_err);
+    void send_signal(const std::string& signal); // e.g. "TERM"; servers may ignore it
+
     std::string read_std_output();
     std::string read_std_error();
 
@@ -69,7 +76,7 @@ private:
     };
 
     void rethrow_if_saved() const;
-    void read_exit_code(std::chrono::milliseconds timeout, bool save_exception);
+    void read_exit_code(std::chrono::milliseconds timeout, bool save_exception, bool drain_output);
     std::string read_stream(StreamType type, int timeout = -1);
     ssh_channel release_channel(); // releases the lock on the session; callers are on their own to ensure thread safety
 
@@ -78,6 +85,7 @@ private:
     std::string cmd;
     ChannelUPtr channel;
     std::variant<std::monostate, int, std::exception_ptr> exit_result;
+    std::array<std::string, 2> buffered_output; // stdout and stderr received while waiting for the exit code
 
     friend class SftpServer;
 };
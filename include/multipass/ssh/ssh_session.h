@@ -25,11 +25,24 @@
 #include <chrono>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 
 namespace multipass
 {
 class SSHKeyProvider;
+
+// Transport tuning for SSH sessions. All profiles prefer AES-GCM when the host has AES instructions and
+// chacha20-poly1305 otherwise; "bulk" moves data in larger chunks for big transfers.
+enum class SSHTransportProfile
+{
+    standard,
+    bulk
+};
+
+std::optional<SSHTransportProfile> ssh_transport_profile_from(const std::string& name);
+std::string ssh_transport_profile_name(SSHTransportProfile profile);
+
 class SSHSession
 {
 public:
@@ -56,6 +69,10 @@ public:
     operator ssh_session(); // careful, not thread safe
     void force_shutdown();  // careful, not thread safe
 
+    // process-wide, applies to sessions opened afterwards
+    static void set_transport_profile(SSHTransportProfile profile);
+    static SSHTransportProfile transport_profile();
+
 private:
     SSHSession(SSHSession&&, std::unique_lock<std::mutex> lock);
 
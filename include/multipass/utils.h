@@ -27,6 +27,8 @@
 
 #include <yaml-cpp/yaml.h>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <functional>
 #include <future>
@@ -195,6 +197,51 @@ void parallel_for_each(Container& input_container, UnaryOperation&& unary_op)
         empty_future.get();
     }
 }
+
+// bounded parallel transform: like parallel_transform, but it runs at most max_concurrency operations at a time and
+// keeps every result, in the same order as the input. With a max_concurrency of 1 (or a single element), operations run
+// sequentially in the calling thread. The first exception thrown by an operation is rethrown, once all workers finish.
+template <typename Container, typename UnaryOperation>
+std::vector<std::invoke_result_t<std::decay_t<UnaryOperation>, typename Container::value_type>>
+bounded_parallel_transform(const Container& input_container, UnaryOperation&& unary_op, std::size_t max_concurrency)
+{
+    using OutputValueType = std::invoke_result_t<std::decay_t<UnaryOperation>, typename Container::value_type>;
+    const auto num_elements = input_container.size();
+
+    std::vector<std::reference_wrapper<const typename Container::value_type>> inputs;
+    inputs.reserve(num_elements);
+    for (const auto& item : input_container)
+        inputs.emplace_back(item);
+
+    std::vector<OutputValueType> results(num_elements);
+    const auto num_workers = std::min(std::max(max_concurrency, std::size_t{1}), num_elements);
+    if (num_workers <= 1)
+    {
+        for (std::size_t i = 0; i < num_elements; ++i)
+            results[i] = unary_op(inputs[i].get());
+
+        return results;
+    }
+
+    std::atomic_size_t next_index{0};
+    auto worker = [&inputs, &results, &next_index, &unary_op] {
+        for (auto i = next_index++; i < inputs.size(); i = next_index++)
+            results[i] = unary_op(inputs[i].get());
+    };
+
+    std::vector<std::future<void>> workers;
+    workers.reserve(num_workers);
+    for (std::size_t i = 0; i < num_workers; ++i)
+        workers.emplace_back(std::async(std::launch::async, worker));
+
+    for (auto& w : workers)
+        w.wait();
+
+    for (auto& w : workers)
+        w.get();
+
+    return results;
+}
 } // namespace utils
 
 class Utils : public Singleton<Utils>
@@ -294,13 +341,16 @@ void multipass::utils::try_action_for(OnTimeoutCallable&& on_timeout, std::chron
     using namespace std::literals::chrono_literals;
 
     auto deadline = std::chrono::steady_clock::now() + timeout;
+    auto retry_delay = std::chrono::milliseconds{50ms};
     while (std::chrono::steady_clock::now() < deadline)
     {
         if (try_action(std::forward<Args>(args)...) == TimeoutAction::done)
             return;
 
-        // retry every second, until timeout - mock this to avoid sleeping at all in tests
-        MP_UTILS.sleep_for(timeout < 1s ? timeout : 1s);
+        // retry with exponential backoff, quickly at first and then every second, until timeout - mock this to avoid
+        // sleeping at all in tests
+        MP_UTILS.sleep_for(std::min(retry_delay, timeout));
+        retry_delay = std::min(retry_delay * 2, std::chrono::milliseconds{1s});
     }
 
     on_timeout();
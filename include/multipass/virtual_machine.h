@@ -87,6 +87,8 @@ public:
     virtual void update_cpus(int num_cores) = 0;
     virtual void resize_memory(const MemorySize& new_size) = 0;
     virtual void resize_disk(const MemorySize& new_size) = 0;
+    virtual void update_disk_profile(const std::string& profile) = 0;   // throws std::invalid_argument if unknown
+    virtual void update_memory_profile(const std::string& profile) = 0; // idem
     virtual void add_network_interface(int index,
                                        const std::string& default_mac_addr,
                                        const NetworkInterface& extra_interface) = 0;
@@ -18,6 +18,7 @@
 #ifndef MULTIPASS_VIRTUAL_MACHINE_DESCRIPTION_H
 #define MULTIPASS_VIRTUAL_MACHINE_DESCRIPTION_H
 
+#include <multipass/constants.h>
 #include <multipass/memory_size.h>
 #include <multipass/network_interface.h>
 #include <multipass/vm_image.h>
@@ -49,6 +50,8 @@ public:
     YAML::Node user_data_config;
     YAML::Node vendor_data_config;
     YAML::Node network_data_config;
+    std::string disk_profile = default_disk_profile;
+    std::string memory_profile = default_memory_profile;
 };
 } // namespace multipass
 
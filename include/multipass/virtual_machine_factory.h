@@ -69,11 +69,17 @@ public:
                                                   const days& days_to_expire) = 0;
     virtual void configure(VirtualMachineDescription& vm_desc) = 0;
 
+    // Sets up the cloud-init configuration of a clone of the source instance, giving the clone its own identity
+    virtual void prepare_clone(const std::string& source_name, VirtualMachineDescription& vm_desc) = 0;
+
     // List all the network interfaces seen by the backend.
     virtual std::vector<NetworkInterfaceInfo> networks() const = 0;
     virtual void require_snapshots_support() const = 0;
     virtual void require_suspend_support() const = 0;
 
+    // Whether create_virtual_machine() can safely be called from several threads at once
+    virtual bool supports_concurrent_vm_creation() const = 0;
+
 protected:
     VirtualMachineFactory() = default;
 
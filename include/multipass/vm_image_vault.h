@@ -88,6 +88,10 @@ public:
                                 const std::optional<std::string>& checksum,
                                 const Path& save_dir) = 0;
     virtual void remove(const std::string& name) = 0;
+    // Copies the instance image of source_name into destination_dir and records it for destination_name
+    virtual VMImage clone(const std::string& source_name,
+                          const std::string& destination_name,
+                          const Path& destination_dir) = 0;
     virtual bool has_record_for(const std::string& name) = 0;
     virtual void prune_expired_images() = 0;
     virtual void update_images(const FetchType& fetch_type, const PrepareAction& prepare,
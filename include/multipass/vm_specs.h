@@ -18,6 +18,7 @@
 #ifndef MULTIPASS_VM_SPECS_H
 #define MULTIPASS_VM_SPECS_H
 
+#include "constants.h"
 #include "memory_size.h"
 #include "network_interface.h"
 #include "virtual_machine.h"
@@ -44,6 +45,8 @@ struct VMSpecs
     std::unordered_map<std::string, VMMount> mounts;
     bool deleted;
     QJsonObject metadata;
+    std::string disk_profile = default_disk_profile;
+    std::string memory_profile = default_memory_profile;
 };
 
 inline bool operator==(const VMSpecs& a, const VMSpecs& b)
@@ -57,16 +60,20 @@ inline bool operator==(const VMSpecs& a, const VMSpecs& b)
                     a.state,
                     a.mounts,
                     a.deleted,
-                    a.metadata) == std::tie(b.num_cores,
-                                            b.mem_size,
-                                            b.disk_space,
-                                            b.default_mac_address,
-                                            b.extra_interfaces,
-                                            b.ssh_username,
-                                            b.state,
-                                            b.mounts,
-                                            b.deleted,
-                                            b.metadata);
+                    a.metadata,
+                    a.disk_profile,
+                    a.memory_profile) == std::tie(b.num_cores,
+                                                  b.mem_size,
+                                                  b.disk_space,
+                                                  b.default_mac_address,
+                                                  b.extra_interfaces,
+                                                  b.ssh_username,
+                                                  b.state,
+                                                  b.mounts,
+                                                  b.deleted,
+                                                  b.metadata,
+                                                  b.disk_profile,
+                                                  b.memory_profile);
 }
 
 inline bool operator!=(const VMSpecs& a, const VMSpecs& b) // TODO drop in C++20
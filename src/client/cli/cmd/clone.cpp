@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "clone.h"
+
+#include "animated_spinner.h"
+#include "common_callbacks.h"
+#include "common_cli.h"
+
+#include <multipass/cli/argparser.h>
+
+namespace mp = multipass;
+namespace cmd = mp::cmd;
+
+mp::ReturnCode cmd::Clone::run(mp::ArgParser* parser)
+{
+    if (auto ret = parse_args(parser); ret != ParseCode::Ok)
+        return parser->returnCodeFrom(ret);
+
+    AnimatedSpinner spinner{cout};
+
+    auto on_success = [this, &spinner](mp::CloneReply& reply) {
+        spinner.stop();
+        fmt::print(cout, "Cloned from {} to {}.\n", request.source_name(), reply.destination_name());
+        return ReturnCode::Ok;
+    };
+
+    auto on_failure = [this, &spinner](grpc::Status& status) {
+        spinner.stop();
+        return standard_failure_handler_for(name(), cerr, status);
+    };
+
+    spinner.start(fmt::format("Cloning {}", request.source_name()));
+    return dispatch(&RpcMethod::clone,
+                    request,
+                    on_success,
+                    on_failure,
+                    make_logging_spinner_callback<CloneRequest, CloneReply>(spinner, cerr));
+}
+
+std::string cmd::Clone::name() const
+{
+    return "clone";
+}
+
+QString cmd::Clone::short_help() const
+{
+    return QStringLiteral("Clone an instance");
+}
+
+QString cmd::Clone::description() const
+{
+    return QStringLiteral("Create an independent copy of a stopped instance, with its own name, MAC addresses and "
+                          "cloud-init identity.\nThe clone does not go through image download and provisioning, and "
+                          "on filesystems that support it its disk shares blocks with the source instance's.");
+}
+
+mp::ParseCode cmd::Clone::parse_args(mp::ArgParser* parser)
+{
+    parser->addPositionalArgument("source", "The name of the instance to clone.");
+    QCommandLineOption name_opt({"n", "name"},
+                                "An optional name for the clone, subject to the same validity rules as instance names "
+                                "(see `help launch`). Default: \"<source>-cloneN\", where N is the lowest number that "
+                                "yields an unused name.",
+                                "name");
+    parser->addOption(name_opt);
+
+    if (auto status = parser->commandParse(this); status != ParseCode::Ok)
+        return status;
+
+    const auto positional_args = parser->positionalArguments();
+    const auto num_args = positional_args.count();
+    if (num_args < 1)
+    {
+        cerr << "Need the name of an instance to clone.\n";
+        return ParseCode::CommandLineError;
+    }
+
+    if (num_args > 1)
+    {
+        cerr << "Too many arguments supplied\n";
+        return ParseCode::CommandLineError;
+    }
+
+    request.set_source_name(positional_args.first().toStdString());
+    request.set_destination_name(parser->value(name_opt).toStdString());
+    request.set_verbosity_level(parser->verbosityLevel());
+
+    return ParseCode::Ok;
+}
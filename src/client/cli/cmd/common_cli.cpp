@@ -24,6 +24,7 @@
 #include <multipass/constants.h>
 #include <multipass/exceptions/cmd_exceptions.h>
 #include <multipass/exceptions/settings_exceptions.h>
+#include <multipass/ssh/ssh_session.h>
 
 #include <QCommandLineOption>
 #include <QString>
@@ -166,6 +167,13 @@ QString multipass::cmd::describe_common_settings_keys()
            " get --keys` to obtain the full list of available settings at any given time.";
 }
 
+void cmd::apply_ssh_transport_profile(const mp::SSHInfo& ssh_info)
+{
+    // the daemon reports its `local.ssh-profile`, so client connections are tuned the same way
+    const auto profile = mp::ssh_transport_profile_from(ssh_info.transport_profile());
+    mp::SSHSession::set_transport_profile(profile.value_or(mp::SSHTransportProfile::standard));
+}
+
 void multipass::cmd::add_timeout(multipass::ArgParser* parser)
 {
     QCommandLineOption timeout_option(
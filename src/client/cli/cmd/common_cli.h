@@ -50,6 +50,7 @@ ReturnCode run_cmd(const QStringList& args, const ArgParser* parser, std::ostrea
 ReturnCode run_cmd_and_retry(const QStringList& args, const ArgParser* parser, std::ostream& cout, std::ostream& cerr);
 ReturnCode return_code_from(const SettingsException& e);
 QString describe_common_settings_keys();
+void apply_ssh_transport_profile(const SSHInfo& ssh_info);
 
 // parser helpers
 void add_timeout(multipass::ArgParser*);
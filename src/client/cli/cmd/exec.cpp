@@ -20,14 +20,17 @@
 
 #include <multipass/cli/argparser.h>
 #include <multipass/ssh/ssh_client.h>
+#include <multipass/utils.h>
 
 namespace mp = multipass;
 namespace cmd = multipass::cmd;
+namespace mpu = multipass::utils;
 
 namespace
 {
 const QString work_dir_option_name{"working-directory"};
 const QString no_dir_mapping_option{"no-map-working-directory"};
+const QString shared_session_option_name{"shared-session"};
 
 auto is_dir_mounted(const QStringList& split_current_dir, const QStringList& split_source_dir)
 {
@@ -42,6 +45,24 @@ auto is_dir_mounted(const QStringList& split_current_dir, const QStringList& spl
 
     return true;
 }
+
+std::vector<std::vector<std::string>> compose_commands(const std::optional<std::string>& dir,
+                                                       const std::vector<std::string>& args)
+{
+    if (!dir)
+        return {args};
+
+    if (args[0] == "sudo")
+    {
+        // If we are running through 'sudo' and need to change directory, it might happen that the default user
+        // does not have access to the folder and thus the cd command will fail. Additionally, `cd` cannot be
+        // ran with sudo, what forces us to run everything through `sh`.
+        auto sh_args = fmt::format("cd {} && {}", *dir, fmt::join(args, " "));
+        return {{"sudo", "sh", "-c", sh_args}};
+    }
+
+    return {{"cd", *dir}, args};
+}
 } // namespace
 
 mp::ReturnCode cmd::Exec::run(mp::ArgParser* parser)
@@ -110,6 +131,9 @@ mp::ReturnCode cmd::Exec::run(mp::ArgParser* parser)
         }
     }
 
+    if (parser->isSet(shared_session_option_name))
+        return run_in_shared_session(work_dir, args, parser);
+
     auto on_success = [this, &args, &work_dir](mp::SSHInfoReply& reply) {
         return exec_success(reply, work_dir, args, term);
     };
@@ -157,30 +181,14 @@ mp::ReturnCode cmd::Exec::exec_success(const mp::SSHInfoReply& reply, const std:
     const auto& port = ssh_info.port();
     const auto& username = ssh_info.username();
     const auto& priv_key_blob = ssh_info.priv_key_base64();
+    apply_ssh_transport_profile(ssh_info);
 
     try
     {
         auto console_creator = [&term](auto channel) { return Console::make_console(channel, term); };
         mp::SSHClient ssh_client{host, port, username, priv_key_blob, console_creator};
 
-        std::vector<std::vector<std::string>> all_args;
-        if (dir)
-        {
-            if (args[0] == "sudo")
-            {
-                // If we are running through 'sudo' and need to change directory, it might happen that the default user
-                // does not have access to the folder and thus the cd command will fail. Additionally, `cd` cannot be
-                // ran with sudo, what forces us to run everything through `sh`.
-                auto sh_args = fmt::format("cd {} && {}", *dir, fmt::join(args, " "));
-                all_args = {{"sudo", "sh", "-c", sh_args}};
-            }
-            else
-                all_args = {{"cd", *dir}, {args}};
-        }
-        else
-            all_args = {{args}};
-
-        return static_cast<mp::ReturnCode>(ssh_client.exec(all_args));
+        return static_cast<mp::ReturnCode>(ssh_client.exec(compose_commands(dir, args)));
     }
     catch (const std::exception& e)
     {
@@ -189,6 +197,52 @@ mp::ReturnCode cmd::Exec::exec_success(const mp::SSHInfoReply& reply, const std:
     }
 }
 
+mp::ReturnCode cmd::Exec::run_in_shared_session(const std::optional<std::string>& dir,
+                                                const std::vector<std::string>& args, mp::ArgParser* parser)
+{
+    const auto& instance_name = ssh_info_request.instance_name(0);
+
+    std::string command;
+    for (const auto& cmd_args : compose_commands(dir, args))
+        command += (command.empty() ? "" : "&&") + mpu::to_cmd(cmd_args, mpu::QuoteType::quote_every_arg);
+
+    // The daemon runs the command over an SSH session it keeps open to the instance, so there is no handshake to pay
+    // here. Output is relayed as it comes, and there is no terminal or input attached.
+    auto on_success = [](mp::ExecReply& reply) { return static_cast<mp::ReturnCode>(reply.exit_code()); };
+
+    auto streaming_callback = [this](mp::ExecReply& reply,
+                                     grpc::ClientReaderWriterInterface<ExecRequest, ExecReply>* client) {
+        if (!reply.log_line().empty())
+            cerr << reply.log_line();
+
+        cout << reply.std_out() << std::flush;
+        cerr << reply.std_err() << std::flush;
+    };
+
+    auto retry = false;
+    auto on_failure = [this, &instance_name, &retry, parser](grpc::Status& status) {
+        if (status.error_code() != grpc::StatusCode::ABORTED)
+            return standard_failure_handler_for(name(), cerr, status);
+
+        auto ret = run_cmd_and_retry({"multipass", "start", QString::fromStdString(instance_name)}, parser, cout, cerr);
+        retry = ret == ReturnCode::Retry;
+        return ret;
+    };
+
+    exec_request.set_instance_name(instance_name);
+    exec_request.set_command(command);
+    exec_request.set_verbosity_level(parser->verbosityLevel());
+
+    ReturnCode return_code;
+    do
+    {
+        retry = false;
+        return_code = dispatch(&RpcMethod::exec, exec_request, on_success, on_failure, streaming_callback);
+    } while (retry);
+
+    return return_code;
+}
+
 mp::ParseCode cmd::Exec::parse_args(mp::ArgParser* parser)
 {
     parser->addPositionalArgument("name", "Name of instance to execute the command on", "<name>");
@@ -197,9 +251,14 @@ mp::ParseCode cmd::Exec::parse_args(mp::ArgParser* parser)
     QCommandLineOption workDirOption({"d", work_dir_option_name}, "Change to <dir> before execution", "dir");
     QCommandLineOption noDirMappingOption({"n", no_dir_mapping_option},
                                           "Do not map the host execution path to a mounted path");
+    QCommandLineOption sharedSessionOption(shared_session_option_name,
+                                           "Run the command over the daemon's already established connection to "
+                                           "the instance, skipping the SSH handshake. No terminal or input is "
+                                           "attached");
 
     parser->addOptions({workDirOption});
     parser->addOptions({noDirMappingOption});
+    parser->addOptions({sharedSessionOption});
 
     auto status = parser->commandParse(this);
 
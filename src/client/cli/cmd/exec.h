@@ -47,9 +47,12 @@ public:
 private:
     SSHInfoRequest ssh_info_request;
     InfoRequest info_request;
+    ExecRequest exec_request;
     AliasDict aliases;
 
     ParseCode parse_args(ArgParser* parser);
+    ReturnCode run_in_shared_session(const std::optional<std::string>& dir, const std::vector<std::string>& args,
+                                     ArgParser* parser);
 };
 } // namespace cmd
 } // namespace multipass
@@ -236,9 +236,18 @@ mp::ParseCode cmd::Launch::parse_args(mp::ArgParser* parser)
                                    "Mount a local directory inside the instance. If <instance-path> is omitted, the "
                                    "mount point will be the same as the absolute path of <local-path>",
                                    "local-path>:<instance-path");
+    QCommandLineOption countOption("count",
+                                   "Number of instances to launch. When more than one, the instances are named after "
+                                   "the given name (or the blueprint), followed by a hyphen and a sequence number, "
+                                   "and --mount is not available. Default: 1.",
+                                   "count");
+    QCommandLineOption parallelOption("parallel",
+                                      "Maximum number of instances to launch at once, when launching several. "
+                                      "Default: 4.",
+                                      "parallel");
 
     parser->addOptions({cpusOption, diskOption, memOption, memOptionDeprecated, nameOption, cloudInitOption,
-                        networkOption, bridgedOption, mountOption});
+                        networkOption, bridgedOption, mountOption, countOption, parallelOption});
 
     mp::cmd::add_timeout(parser);
 
@@ -312,6 +321,34 @@ mp::ParseCode cmd::Launch::parse_args(mp::ArgParser* parser)
         request.set_num_cores(cpu_count);
     }
 
+    for (const auto& [option, setter] : {std::pair{&countOption, &LaunchRequest::set_count},
+                                         std::pair{&parallelOption, &LaunchRequest::set_parallelism}})
+    {
+        if (parser->isSet(*option))
+        {
+            bool conversion_pass;
+            const auto& text = parser->value(*option);
+            const int value = text.toInt(&conversion_pass);
+
+            if (!conversion_pass || value < 1)
+            {
+                fmt::print(cerr,
+                           "Error: invalid {} '{}', need a positive integer value.\n",
+                           option->names().constLast(),
+                           text);
+                return ParseCode::CommandLineError;
+            }
+
+            (request.*setter)(value);
+        }
+    }
+
+    if (request.count() > 1 && parser->isSet(mountOption))
+    {
+        cerr << "Error: mounts cannot be requested when launching several instances.\n";
+        return ParseCode::CommandLineError;
+    }
+
     if (parser->isSet(memOption) || parser->isSet(memOptionDeprecated))
     {
         if (parser->isSet(memOption) && parser->isSet(memOptionDeprecated))
@@ -457,49 +494,18 @@ mp::ReturnCode cmd::Launch::request_launch(const ArgParser* parser)
         if (timer)
             timer->pause();
 
-        instance_name = QString::fromStdString(request.instance_name().empty() ? reply.vm_instance_name()
-                                                                               : request.instance_name());
-
-        std::vector<std::string> warning_aliases;
-        for (const auto& alias_to_be_created : reply.aliases_to_be_created())
+        if (request.count() > 1) // each instance was reported as it got ready
         {
-            AliasDefinition alias_definition{alias_to_be_created.instance(), alias_to_be_created.command(),
-                                             alias_to_be_created.working_directory()};
-            if (create_alias(aliases, alias_to_be_created.name(), alias_definition, cout, cerr,
-                             instance_name.toStdString()) != ReturnCode::Ok)
-                warning_aliases.push_back(alias_to_be_created.name());
-        }
+            if (term->is_live() && update_available(reply.update_info()))
+                cout << update_notice(reply.update_info());
 
-        if (warning_aliases.size())
-            cerr << fmt::format("Warning: unable to create {} {}.\n",
-                                warning_aliases.size() == 1 ? "alias" : "aliases",
-                                fmt::join(warning_aliases, ", "));
-
-        for (const auto& workspace_to_be_created : reply.workspaces_to_be_created())
-        {
-            auto home_dir = mpu::in_multipass_snap() ? QString::fromLocal8Bit(mpu::snap_real_home_dir())
-                                                     : MP_STDPATHS.writableLocation(StandardPaths::HomeLocation);
-            auto full_path_str = home_dir + "/multipass/" + QString::fromStdString(workspace_to_be_created);
+            return ReturnCode::Ok;
+        }
 
-            QDir full_path(full_path_str);
-            if (full_path.exists())
-            {
-                cerr << fmt::format("Folder \"{}\" already exists.\n", full_path_str);
-            }
-            else
-            {
-                if (!MP_FILEOPS.mkpath(full_path, full_path_str))
-                {
-                    cerr << fmt::format("Error creating folder {}. Not mounting.\n", full_path_str);
-                    continue;
-                }
-            }
+        instance_name = QString::fromStdString(request.instance_name().empty() ? reply.vm_instance_name()
+                                                                               : request.instance_name());
 
-            if (mount(parser, full_path_str, QString::fromStdString(workspace_to_be_created)) != ReturnCode::Ok)
-            {
-                cerr << fmt::format("Error mounting folder {}.\n", full_path_str);
-            }
-        }
+        create_aliases_and_workspaces(parser, reply);
 
         cout << "Launched: " << reply.vm_instance_name() << "\n";
 
@@ -553,8 +559,8 @@ mp::ReturnCode cmd::Launch::request_launch(const ArgParser* parser)
         return standard_failure_handler_for(name(), cerr, status, error_details);
     };
 
-    auto streaming_callback = [this](mp::LaunchReply& reply,
-                                     grpc::ClientReaderWriterInterface<LaunchRequest, LaunchReply>* client) {
+    auto streaming_callback = [this, parser](mp::LaunchReply& reply,
+                                             grpc::ClientReaderWriterInterface<LaunchRequest, LaunchReply>* client) {
         std::unordered_map<int, std::string> progress_messages{
             {LaunchProgress_ProgressTypes_IMAGE, "Retrieving image: "},
             {LaunchProgress_ProgressTypes_EXTRACT, "Extracting image: "},
@@ -586,6 +592,14 @@ mp::ReturnCode cmd::Launch::request_launch(const ArgParser* parser)
             spinner->stop();
             spinner->start(reply.create_message());
         }
+        else if (reply.create_oneof_case() == mp::LaunchReply::CreateOneofCase::kVmInstanceName &&
+                 request.count() > 1)
+        {
+            spinner->stop();
+            instance_name = QString::fromStdString(reply.vm_instance_name());
+            create_aliases_and_workspaces(parser, reply);
+            cout << "Launched: " << reply.vm_instance_name() << "\n";
+        }
         else if (!reply.reply_message().empty())
         {
             spinner->stop();
@@ -596,6 +610,51 @@ mp::ReturnCode cmd::Launch::request_launch(const ArgParser* parser)
     return dispatch(&RpcMethod::launch, request, on_success, on_failure, streaming_callback);
 }
 
+// Sets up what the instance's blueprint asks of the client, for the instance named in the reply
+void cmd::Launch::create_aliases_and_workspaces(const ArgParser* parser, const mp::LaunchReply& reply)
+{
+    std::vector<std::string> warning_aliases;
+    for (const auto& alias_to_be_created : reply.aliases_to_be_created())
+    {
+        AliasDefinition alias_definition{alias_to_be_created.instance(), alias_to_be_created.command(),
+                                         alias_to_be_created.working_directory()};
+        if (create_alias(aliases, alias_to_be_created.name(), alias_definition, cout, cerr,
+                         instance_name.toStdString()) != ReturnCode::Ok)
+            warning_aliases.push_back(alias_to_be_created.name());
+    }
+
+    if (warning_aliases.size())
+        cerr << fmt::format("Warning: unable to create {} {}.\n",
+                            warning_aliases.size() == 1 ? "alias" : "aliases",
+                            fmt::join(warning_aliases, ", "));
+
+    for (const auto& workspace_to_be_created : reply.workspaces_to_be_created())
+    {
+        auto home_dir = mpu::in_multipass_snap() ? QString::fromLocal8Bit(mpu::snap_real_home_dir())
+                                                 : MP_STDPATHS.writableLocation(StandardPaths::HomeLocation);
+        auto full_path_str = home_dir + "/multipass/" + QString::fromStdString(workspace_to_be_created);
+
+        QDir full_path(full_path_str);
+        if (full_path.exists())
+        {
+            cerr << fmt::format("Folder \"{}\" already exists.\n", full_path_str);
+        }
+        else
+        {
+            if (!MP_FILEOPS.mkpath(full_path, full_path_str))
+            {
+                cerr << fmt::format("Error creating folder {}. Not mounting.\n", full_path_str);
+                continue;
+            }
+        }
+
+        if (mount(parser, full_path_str, QString::fromStdString(workspace_to_be_created)) != ReturnCode::Ok)
+        {
+            cerr << fmt::format("Error mounting folder {}.\n", full_path_str);
+        }
+    }
+}
+
 auto cmd::Launch::mount(const mp::ArgParser* parser, const QString& mount_source, const QString& mount_target)
     -> ReturnCode
 {
@@ -51,6 +51,7 @@ public:
 private:
     ParseCode parse_args(ArgParser* parser);
     ReturnCode request_launch(const ArgParser* parser);
+    void create_aliases_and_workspaces(const ArgParser* parser, const LaunchReply& reply);
     ReturnCode mount(const ArgParser* parser, const QString& mount_source, const QString& mount_target);
     bool ask_bridge_permission(multipass::LaunchReply& reply);
 
@@ -69,6 +69,7 @@ mp::ReturnCode cmd::Shell::run(mp::ArgParser* parser)
         const auto& port = ssh_info.port();
         const auto& username = ssh_info.username();
         const auto& priv_key_blob = ssh_info.priv_key_base64();
+        apply_ssh_transport_profile(ssh_info);
 
         try
         {
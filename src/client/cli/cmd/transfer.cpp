@@ -51,6 +51,7 @@ mp::ReturnCode cmd::Transfer::run(mp::ArgParser* parser)
         {
             try
             {
+                apply_ssh_transport_profile(ssh_info);
                 auto sftp_client = MP_SFTPUTILS.make_SFTPClient(ssh_info.host(), ssh_info.port(), ssh_info.username(),
                                                                 ssh_info.priv_key_base64());
 
@@ -30,6 +30,7 @@
 #include <multipass/exceptions/invalid_memory_size_exception.h>
 #include <multipass/exceptions/not_implemented_on_this_backend_exception.h>
 #include <multipass/exceptions/snapshot_exceptions.h>
+#include <multipass/exceptions/ssh_exception.h>
 #include <multipass/exceptions/sshfs_missing_error.h>
 #include <multipass/exceptions/start_exception.h>
 #include <multipass/ip_address.h>
@@ -65,6 +66,7 @@
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QJsonParseError>
+#include <QSemaphore>
 #include <QString>
 #include <QSysInfo>
 #include <QtConcurrent/QtConcurrent>
@@ -74,6 +76,7 @@
 #include <functional>
 #include <optional>
 #include <stdexcept>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 #include <variant>
@@ -91,7 +94,15 @@ using namespace std::chrono_literals;
 using error_string = std::string;
 
 constexpr auto category = "daemon";
+constexpr auto max_concurrent_instance_restores = 8u;
+constexpr auto default_launch_parallelism = 4;
+constexpr auto instance_db_flush_delay = 200ms; // coalesce bursts of state changes into a single write
+constexpr auto max_instance_journal_entries = 256; // beyond this, rewrite the instance database instead
 constexpr auto instance_db_name = "multipassd-vm-instances.json";
+constexpr auto instance_journal_name = "multipassd-vm-instances.journal";
+constexpr auto exec_output_poll_interval = 100ms;
+constexpr auto exec_reply_chunk_size = 1024u * 1024u; // well below gRPC's default message size limit
+constexpr auto max_idle_exec_sessions = 2u;
 constexpr auto reboot_cmd = "sudo reboot";
 constexpr auto stop_ssh_cmd = "sudo systemctl stop ssh";
 const std::string sshfs_error_template = "Error enabling mount support in '{}'"
@@ -214,7 +225,66 @@ auto name_from(const std::string& requested_name, const std::string& blueprint_n
     }
 }
 
-std::unordered_map<std::string, mp::VMSpecs> load_db(const mp::Path& data_path, const mp::Path& cache_path)
+// Names for the instances of a batch launch: "<prefix>-<n>", or unique generated names when there is no prefix
+std::vector<std::string> batch_instance_names(const std::string& prefix,
+                                              int count,
+                                              mp::NameGenerator& name_gen,
+                                              std::unordered_set<std::string> used_names)
+{
+    std::vector<std::string> names;
+    names.reserve(count);
+
+    for (auto i = 1; i <= count; ++i)
+    {
+        auto name = prefix.empty() ? name_from("", "", name_gen, used_names) : fmt::format("{}-{}", prefix, i);
+        used_names.insert(name);
+        names.push_back(std::move(name));
+    }
+
+    return names;
+}
+
+// Lets several concurrent operations share a client stream, one message at a time
+template <typename Reply, typename Request>
+class SynchronizedServerReaderWriter : public grpc::ServerReaderWriterInterface<Reply, Request>
+{
+public:
+    explicit SynchronizedServerReaderWriter(grpc::ServerReaderWriterInterface<Reply, Request>* server) : server{server}
+    {
+    }
+
+    void SendInitialMetadata() override
+    {
+        const std::lock_guard lock{mutex};
+        server->SendInitialMetadata();
+    }
+
+    bool Write(const Reply& msg, grpc::WriteOptions options) override
+    {
+        const std::lock_guard lock{mutex};
+        return server->Write(msg, options);
+    }
+
+    bool NextMessageSize(uint32_t* sz) override
+    {
+        const std::lock_guard lock{mutex};
+        return server->NextMessageSize(sz);
+    }
+
+    bool Read(Request* msg) override
+    {
+        const std::lock_guard lock{mutex};
+        return server->Read(msg);
+    }
+
+private:
+    grpc::ServerReaderWriterInterface<Reply, Request>* server;
+    std::mutex mutex;
+};
+
+std::unordered_map<std::string, mp::VMSpecs> load_db(const mp::Path& data_path,
+                                                     const mp::Path& cache_path,
+                                                     mp::InstanceJournal& journal)
 {
     QDir data_dir{data_path};
     QDir cache_dir{cache_path};
@@ -232,7 +302,7 @@ std::unordered_map<std::string, mp::VMSpecs> load_db(const mp::Path& data_path,
     if (doc.isNull())
         return {};
 
-    auto records = doc.object();
+    auto records = journal.replay(doc.object());
     if (records.isEmpty())
         return {};
 
@@ -251,6 +321,8 @@ std::unordered_map<std::string, mp::VMSpecs> load_db(const mp::Path& data_path,
         auto state = record["state"].toInt();
         auto deleted = record["deleted"].toBool();
         auto metadata = record["metadata"].toObject();
+        auto disk_profile = record["disk_profile"].toString().toStdString();
+        auto memory_profile = record["memory_profile"].toString().toStdString();
 
         if (!num_cores && !deleted && ssh_username.empty() && metadata.isEmpty() &&
             !mp::MemorySize{mem_size}.in_bytes() && !mp::MemorySize{disk_space}.in_bytes())
@@ -287,7 +359,9 @@ std::unordered_map<std::string, mp::VMSpecs> load_db(const mp::Path& data_path,
             static_cast<mp::VirtualMachine::State>(state),
             mounts,
             deleted,
-            metadata};
+            metadata,
+            disk_profile.empty() ? mp::default_disk_profile : disk_profile,
+            memory_profile.empty() ? mp::default_memory_profile : memory_profile};
     }
     return reconstructed_records;
 }
@@ -302,6 +376,8 @@ QJsonObject vm_spec_to_json(const mp::VMSpecs& specs)
     json.insert("state", static_cast<int>(specs.state));
     json.insert("deleted", specs.deleted);
     json.insert("metadata", specs.metadata);
+    json.insert("disk_profile", QString::fromStdString(specs.disk_profile));
+    json.insert("memory_profile", QString::fromStdString(specs.memory_profile));
 
     // Write the networking information. Write first a field "mac_addr" containing the MAC address of the
     // default network interface. Then, write all the information about the rest of the interfaces.
@@ -553,6 +629,7 @@ auto connect_rpc(mp::DaemonRpc& rpc, mp::Daemon& daemon)
     QObject::connect(&rpc, &mp::DaemonRpc::on_mount, &daemon, &mp::Daemon::mount);
     QObject::connect(&rpc, &mp::DaemonRpc::on_recover, &daemon, &mp::Daemon::recover);
     QObject::connect(&rpc, &mp::DaemonRpc::on_ssh_info, &daemon, &mp::Daemon::ssh_info);
+    QObject::connect(&rpc, &mp::DaemonRpc::on_exec, &daemon, &mp::Daemon::exec);
     QObject::connect(&rpc, &mp::DaemonRpc::on_start, &daemon, &mp::Daemon::start);
     QObject::connect(&rpc, &mp::DaemonRpc::on_stop, &daemon, &mp::Daemon::stop);
     QObject::connect(&rpc, &mp::DaemonRpc::on_suspend, &daemon, &mp::Daemon::suspend);
@@ -566,6 +643,7 @@ auto connect_rpc(mp::DaemonRpc& rpc, mp::Daemon& daemon)
     QObject::connect(&rpc, &mp::DaemonRpc::on_authenticate, &daemon, &mp::Daemon::authenticate);
     QObject::connect(&rpc, &mp::DaemonRpc::on_snapshot, &daemon, &mp::Daemon::snapshot);
     QObject::connect(&rpc, &mp::DaemonRpc::on_restore, &daemon, &mp::Daemon::restore);
+    QObject::connect(&rpc, &mp::DaemonRpc::on_clone, &daemon, &mp::Daemon::clone);
 }
 
 enum class InstanceGroup
@@ -1043,6 +1121,14 @@ std::string generate_unused_mac_address(std::unordered_set<std::string>& s)
                     max_tries, s.size())};
 }
 
+// Generate a name of the form "<source>-cloneN" that is not in used_names, with the lowest such N
+std::string generate_clone_name(const std::string& source_name, const std::unordered_set<std::string>& used_names)
+{
+    for (auto i = 1;; ++i)
+        if (auto name = fmt::format("{}-clone{}", source_name, i); used_names.find(name) == used_names.end())
+            return name;
+}
+
 struct SnapshotPick
 {
     std::unordered_set<std::string> pick;
@@ -1273,13 +1359,39 @@ void populate_snapshot_info(mp::VirtualMachine& vm,
 
     populate_snapshot_fundamentals(snapshot, fundamentals);
 }
+
+// Returns false once the client is gone
+bool relay_exec_output(grpc::ServerReaderWriterInterface<mp::ExecReply, mp::ExecRequest>& server,
+                       std::string_view out,
+                       std::string_view err)
+{
+    while (!out.empty() || !err.empty())
+    {
+        const auto out_chunk = out.substr(0, exec_reply_chunk_size);
+        const auto err_chunk = err.substr(0, exec_reply_chunk_size);
+        out.remove_prefix(out_chunk.size());
+        err.remove_prefix(err_chunk.size());
+
+        mp::ExecReply reply;
+        reply.set_std_out(std::string{out_chunk});
+        reply.set_std_err(std::string{err_chunk});
+        if (!server.Write(reply))
+            return false;
+    }
+
+    return true;
+}
 } // namespace
 
 mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
     : config{std::move(the_config)},
+      instance_journal{QDir{mp::utils::backend_directory_path(config->data_directory,
+                                                              config->factory->get_backend_directory_name())}
+                           .filePath(instance_journal_name)},
       vm_instance_specs{load_db(
           mp::utils::backend_directory_path(config->data_directory, config->factory->get_backend_directory_name()),
-          mp::utils::backend_directory_path(config->cache_directory, config->factory->get_backend_directory_name()))},
+          mp::utils::backend_directory_path(config->cache_directory, config->factory->get_backend_directory_name()),
+          instance_journal)},
       daemon_rpc{config->server_address, *config->cert_provider, config->client_cert_store.get()},
       instance_mod_handler{register_instance_mod(
           vm_instance_specs,
@@ -1293,6 +1405,11 @@ mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
           register_snapshot_mod(operative_instances, deleted_instances, preparing_instances, *config->factory)}
 {
     connect_rpc(daemon_rpc, *this);
+
+    persist_instances_timer.setSingleShot(true);
+    persist_instances_timer.setInterval(instance_db_flush_delay);
+    connect(&persist_instances_timer, &QTimer::timeout, this, &Daemon::flush_instances);
+
     std::vector<std::string> invalid_specs;
 
     try
@@ -1304,6 +1421,7 @@ mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
         mpl::log(mpl::Level::warning, category, fmt::format("Hypervisor health check failed: {}", e.what()));
     }
 
+    std::vector<VirtualMachineDescription> vm_descs;
     for (auto& entry : vm_instance_specs)
     {
         const auto& name = entry.first;
@@ -1337,28 +1455,51 @@ mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
             continue;
         }
 
+        allocated_mac_addrs = std::move(new_macs); // Add the new macs to the daemon's list only if we got this far
+
         const auto instance_dir = mp::utils::base_dir(vm_image.image_path);
         const auto cloud_init_iso = instance_dir.filePath("cloud-init-config.iso");
-        mp::VirtualMachineDescription vm_desc{spec.num_cores,
-                                              spec.mem_size,
-                                              spec.disk_space,
-                                              name,
-                                              spec.default_mac_address,
-                                              spec.extra_interfaces,
-                                              spec.ssh_username,
-                                              vm_image,
-                                              cloud_init_iso,
-                                              {},
-                                              {},
-                                              {},
-                                              {}};
+        vm_descs.push_back({spec.num_cores,
+                            spec.mem_size,
+                            spec.disk_space,
+                            name,
+                            spec.default_mac_address,
+                            spec.extra_interfaces,
+                            spec.ssh_username,
+                            vm_image,
+                            cloud_init_iso,
+                            {},
+                            {},
+                            {},
+                            {},
+                            spec.disk_profile,
+                            spec.memory_profile});
+    }
 
-        auto& instance_record = spec.deleted ? deleted_instances : operative_instances;
-        auto instance = instance_record[name] =
-            config->factory->create_virtual_machine(vm_desc, *config->ssh_key_provider, *this);
+    // Reconstructing instances may involve slow backend work (e.g. running qemu-img on each image), so do it in
+    // parallel when the backend allows it
+    auto restore_instance = [this](const VirtualMachineDescription& vm_desc) -> VirtualMachine::ShPtr {
+        auto instance = config->factory->create_virtual_machine(vm_desc, *config->ssh_key_provider, *this);
         instance->load_snapshots();
 
-        allocated_mac_addrs = std::move(new_macs); // Add the new macs to the daemon's list only if we got this far
+        // Instances that are QObjects need to live in the daemon's thread to keep receiving queued signals
+        if (auto qobject = dynamic_cast<QObject*>(instance.get()))
+            qobject->moveToThread(thread());
+
+        return instance;
+    };
+
+    const auto restore_concurrency =
+        config->factory->supports_concurrent_vm_creation() ? max_concurrent_instance_restores : 1u;
+    auto restored_instances = mpu::bounded_parallel_transform(vm_descs, restore_instance, restore_concurrency);
+
+    for (std::size_t i = 0; i < vm_descs.size(); ++i)
+    {
+        const auto& name = vm_descs[i].vm_name;
+        auto& spec = vm_instance_specs[name];
+
+        auto& instance_record = spec.deleted ? deleted_instances : operative_instances;
+        instance_record[name] = std::move(restored_instances[i]);
 
         // FIXME: somehow we're writing contradictory state to disk.
         if (spec.deleted && spec.state != VirtualMachine::State::stopped && spec.state != VirtualMachine::State::off)
@@ -1374,19 +1515,11 @@ mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
 
         if (!spec.deleted)
             init_mounts(name);
-        std::unique_lock lock{start_mutex};
-        if (spec.state == VirtualMachine::State::running &&
-            operative_instances[name]->current_state() != VirtualMachine::State::running &&
-            operative_instances[name]->current_state() != VirtualMachine::State::starting)
+
+        if (spec.state == VirtualMachine::State::running)
         {
             assert(!spec.deleted);
-            mpl::log(mpl::Level::info, category, fmt::format("{} needs starting. Starting now...", name));
-
-            multipass::top_catch_all(name, [this, &name, &lock]() {
-                operative_instances[name]->start();
-                lock.unlock();
-                on_restart(name);
-            });
+            pending_autostarts.push_back(name);
         }
     }
 
@@ -1396,8 +1529,8 @@ mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
         vm_instance_specs.erase(bad_spec);
     }
 
-    if (!invalid_specs.empty())
-        persist_instances();
+    if (!invalid_specs.empty() || instance_journal.size())
+        persist_instances(); // fold the journal back into the database, so that it doesn't grow across restarts
 
     config->vault->prune_expired_images();
 
@@ -1444,6 +1577,40 @@ mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
         }
     });
     source_images_maintenance_task.start(config->image_refresh_timer);
+
+    // Autostart previously running instances once the event loop is up, rather than blocking the constructor
+    if (!pending_autostarts.empty())
+        QMetaObject::invokeMethod(this, &Daemon::autostart_pending_instances, Qt::QueuedConnection);
+}
+
+void mp::Daemon::autostart_pending_instances()
+{
+    if (pending_autostarts.empty())
+        return;
+
+    auto it = operative_instances.find(pending_autostarts.front());
+    pending_autostarts.pop_front();
+
+    // Start one instance per event loop iteration, so that requests can be served in the meantime
+    if (!pending_autostarts.empty())
+        QMetaObject::invokeMethod(this, &Daemon::autostart_pending_instances, Qt::QueuedConnection);
+
+    if (it == operative_instances.end() || vm_instance_specs[it->first].state != VirtualMachine::State::running)
+        return; // the instance was deleted or stopped in the meantime
+
+    std::unique_lock lock{start_mutex};
+    const auto& name = it->first;
+    auto& vm = it->second;
+    if (vm->current_state() != VirtualMachine::State::running && vm->current_state() != VirtualMachine::State::starting)
+    {
+        mpl::log(mpl::Level::info, category, fmt::format("{} needs starting. Starting now...", name));
+
+        multipass::top_catch_all(name, [this, &name, &vm, &lock]() {
+            vm->start();
+            lock.unlock();
+            on_restart(name);
+        });
+    }
 }
 
 mp::Daemon::~Daemon()
@@ -1452,6 +1619,12 @@ mp::Daemon::~Daemon()
         MP_SETTINGS.unregister_handler(instance_mod_handler);
         MP_SETTINGS.unregister_handler(snapshot_mod_handler);
     });
+
+    mp::top_catch_all(category, [this] {
+        flush_instances(); // don't lose state changes that are still pending
+        if (instance_journal.size())
+            persist_instances(); // leave a self-contained database behind
+    });
 }
 
 void mp::Daemon::shutdown_grpc_server()
@@ -1481,6 +1654,9 @@ try // clang-format on
     mpl::ClientLogger<LaunchReply, LaunchRequest> logger{mpl::level_from(request->verbosity_level()), *config->logger,
                                                          server};
 
+    if (request->count() > 1)
+        return launch_batch(request, server, status_promise);
+
     return create_vm(request, server, status_promise, /*start=*/true);
 }
 catch (const mp::StartException& e)
@@ -2033,6 +2209,76 @@ catch (const std::exception& e)
     status_promise->set_value(grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, e.what(), ""));
 }
 
+void mp::Daemon::exec(const ExecRequest* request, grpc::ServerReaderWriterInterface<ExecReply, ExecRequest>* server,
+                      std::promise<grpc::Status>* status_promise, std::function<bool()> is_cancelled) // clang-format off
+try // clang-format on
+{
+    mpl::ClientLogger<ExecReply, ExecRequest> logger{mpl::level_from(request->verbosity_level()), *config->logger,
+                                                     server};
+
+    const std::vector<std::string> names{request->instance_name()};
+    auto [instance_selection, status] = select_instances_and_react(operative_instances, deleted_instances, names,
+                                                                   InstanceGroup::None,
+                                                                   require_operative_instances_reaction);
+    if (!status.ok() || !(status = check_ssh_access(*instance_selection.operative_selection.front()->second)).ok())
+    {
+        status_promise->set_value(status);
+        return;
+    }
+
+    // The command goes through an SSH session that the daemon keeps open across invocations, so repeated ones skip the
+    // key exchange and authentication that a fresh client connection would pay. Run it off the daemon thread, as it may
+    // take a while; like a regular SSH exec, it is not given a deadline, but it is stopped when the client goes away.
+    auto vm = instance_selection.operative_selection.front()->second;
+    QtConcurrent::run([this, vm, command = request->command(), server, status_promise, is_cancelled] {
+        try
+        {
+            auto session = checkout_exec_session(*vm);
+            std::optional<SSHProcess> process;
+            try
+            {
+                process.emplace(session->exec(command));
+            }
+            catch (const SSHException&)
+            {
+                session = open_exec_session(*vm); // idle sessions may have gone stale without noticing
+                process.emplace(session->exec(command));
+            }
+
+            std::string out, err;
+            while (!process->wait_for_output(exec_output_poll_interval, out, err))
+            {
+                if (!relay_exec_output(*server, out, err) || is_cancelled())
+                {
+                    // the session is dropped along with the process, which would otherwise keep it busy
+                    mpl::log(mpl::Level::debug, category, fmt::format("Client gone, stopping \"{}\"", command));
+                    process->send_signal("TERM");
+                    return status_promise->set_value(grpc::Status::CANCELLED);
+                }
+            }
+
+            const auto exit_code = process->exit_code();
+            relay_exec_output(*server, out + process->read_std_output(), err + process->read_std_error());
+            process.reset();
+            checkin_exec_session(vm->vm_name, std::move(session));
+
+            ExecReply reply;
+            reply.set_exit_code(exit_code);
+            server->Write(reply);
+
+            status_promise->set_value(grpc::Status::OK);
+        }
+        catch (const std::exception& e)
+        {
+            status_promise->set_value(grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, e.what(), ""));
+        }
+    });
+}
+catch (const std::exception& e)
+{
+    status_promise->set_value(grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, e.what(), ""));
+}
+
 void mp::Daemon::start(const StartRequest* request, grpc::ServerReaderWriterInterface<StartReply, StartRequest>* server,
                        std::promise<grpc::Status>* status_promise) // clang-format off
 try // clang-format on
@@ -2668,6 +2914,133 @@ catch (const std::exception& e)
     status_promise->set_value(grpc::Status(grpc::StatusCode::INTERNAL, e.what(), ""));
 }
 
+void mp::Daemon::clone(const CloneRequest* request,
+                       grpc::ServerReaderWriterInterface<CloneReply, CloneRequest>* server,
+                       std::promise<grpc::Status>* status_promise)
+try
+{
+    mpl::ClientLogger<CloneReply, CloneRequest> logger{mpl::level_from(request->verbosity_level()),
+                                                       *config->logger,
+                                                       server};
+
+    const auto& source_name = request->source_name();
+    auto [instance_trail, status] = find_instance_and_react(operative_instances,
+                                                            deleted_instances,
+                                                            source_name,
+                                                            require_operative_instances_reaction);
+    if (!status.ok())
+        return status_promise->set_value(status);
+
+    assert(instance_trail.index() == 0);
+    auto* source_vm = std::get<0>(instance_trail)->second.get();
+    assert(source_vm);
+
+    auto destination_name = request->destination_name();
+    if (destination_name.empty())
+    {
+        std::unordered_set<std::string> used_names{preparing_instances};
+        for (const auto* table : {&operative_instances, &deleted_instances})
+            for (const auto& instance : *table)
+                used_names.insert(instance.first);
+
+        destination_name = generate_clone_name(source_name, used_names);
+    }
+    else if (!mp::utils::valid_hostname(destination_name))
+        return status_promise->set_value(
+            grpc::Status{grpc::INVALID_ARGUMENT, fmt::format(R"(Invalid instance name: "{}".)", destination_name)});
+
+    const auto destination_status = find_instance_and_react(operative_instances,
+                                                            deleted_instances,
+                                                            destination_name,
+                                                            require_missing_instances_reaction)
+                                        .second;
+    if (!destination_status.ok())
+        return status_promise->set_value(destination_status);
+
+    if (preparing_instances.find(destination_name) != preparing_instances.end())
+        return status_promise->set_value({grpc::StatusCode::INVALID_ARGUMENT,
+                                          fmt::format("instance \"{}\" is being prepared", destination_name),
+                                          ""});
+
+    // The disk of a running instance is not consistent, and its internal snapshots would have to be carried over
+    using St = VirtualMachine::State;
+    if (auto state = source_vm->current_state(); state != St::off && state != St::stopped)
+        return status_promise->set_value(
+            grpc::Status{grpc::INVALID_ARGUMENT, "Multipass can only clone stopped instances."});
+
+    if (source_vm->get_num_snapshots() > 0)
+        return status_promise->set_value(
+            grpc::Status{grpc::INVALID_ARGUMENT, "Multipass cannot clone instances that have snapshots."});
+
+    const auto spec_it = vm_instance_specs.find(source_name);
+    assert(spec_it != vm_instance_specs.end() && "missing instance specs");
+
+    // The clone gets its own MAC addresses, so that it can share networks with its source
+    auto destination_specs = spec_it->second;
+    destination_specs.state = St::off;
+    {
+        const std::lock_guard lock{allocated_mac_addrs_mutex};
+        auto new_macs = allocated_mac_addrs;
+
+        destination_specs.default_mac_address = generate_unused_mac_address(new_macs);
+        for (auto& iface : destination_specs.extra_interfaces)
+            iface.mac_address = generate_unused_mac_address(new_macs);
+
+        allocated_mac_addrs = std::move(new_macs);
+    }
+    vm_instance_specs[destination_name] = destination_specs;
+
+    try
+    {
+        const auto vm_image = config->vault->clone(source_name,
+                                                   destination_name,
+                                                   config->factory->get_instance_directory(destination_name));
+
+        VirtualMachineDescription vm_desc{destination_specs.num_cores,
+                                          destination_specs.mem_size,
+                                          destination_specs.disk_space,
+                                          destination_name,
+                                          destination_specs.default_mac_address,
+                                          destination_specs.extra_interfaces,
+                                          destination_specs.ssh_username,
+                                          vm_image,
+                                          "",
+                                          {},
+                                          {},
+                                          {},
+                                          {},
+                                          destination_specs.disk_profile,
+                                          destination_specs.memory_profile};
+        config->factory->prepare_clone(source_name, vm_desc);
+
+        operative_instances[destination_name] =
+            config->factory->create_virtual_machine(vm_desc, *config->ssh_key_provider, *this);
+    }
+    catch (const std::exception&)
+    {
+        release_resources(destination_name);
+        operative_instances.erase(destination_name);
+        throw;
+    }
+
+    init_mounts(destination_name);
+    persist_instances();
+
+    CloneReply reply;
+    reply.set_destination_name(destination_name);
+    server->Write(reply);
+
+    status_promise->set_value(grpc::Status::OK);
+}
+catch (const mp::NotImplementedOnThisBackendException& e)
+{
+    status_promise->set_value(grpc::Status{grpc::StatusCode::FAILED_PRECONDITION, e.what(), ""});
+}
+catch (const std::exception& e)
+{
+    status_promise->set_value(grpc::Status(grpc::StatusCode::INTERNAL, e.what(), ""));
+}
+
 void mp::Daemon::on_shutdown()
 {
 }
@@ -2702,23 +3075,65 @@ void mp::Daemon::on_restart(const std::string& name)
 void mp::Daemon::persist_state_for(const std::string& name, const VirtualMachine::State& state)
 {
     vm_instance_specs[name].state = state;
-    persist_instances();
+    schedule_persist_for(name);
 }
 
 void mp::Daemon::update_metadata_for(const std::string& name, const QJsonObject& metadata)
 {
     vm_instance_specs[name].metadata = metadata;
 
-    persist_instances();
+    schedule_persist_for(name);
 }
 
 QJsonObject mp::Daemon::retrieve_metadata_for(const std::string& name)
 {
-    return vm_instance_specs[name].metadata;
+    // this may be called concurrently while instances are being restored, so avoid inserting
+    auto it = vm_instance_specs.find(name);
+    return it != vm_instance_specs.end() ? it->second.metadata : QJsonObject{};
+}
+
+void mp::Daemon::schedule_persist_for(const std::string& name)
+{
+    const std::lock_guard lock{dirty_instances_mutex};
+
+    // Instances report their state from all sorts of threads; the timer can only be started from the daemon's
+    if (dirty_instances.insert(name).second && dirty_instances.size() == 1)
+        QMetaObject::invokeMethod(&persist_instances_timer, [this] { persist_instances_timer.start(); });
+}
+
+void mp::Daemon::flush_instances()
+{
+    std::unordered_set<std::string> names;
+    {
+        const std::lock_guard lock{dirty_instances_mutex};
+        names.swap(dirty_instances);
+    }
+
+    if (names.empty())
+        return;
+
+    // Log just the records that changed, unless the journal got long enough to be worth folding into the database
+    if (instance_journal.size() < max_instance_journal_entries)
+    {
+        QJsonObject changed_records_json;
+        for (const auto& name : names)
+            if (auto it = vm_instance_specs.find(name); it != vm_instance_specs.end())
+                changed_records_json.insert(QString::fromStdString(name), vm_spec_to_json(it->second));
+
+        if (instance_journal.append(changed_records_json))
+            return;
+    }
+
+    persist_instances();
 }
 
 void mp::Daemon::persist_instances()
 {
+    {
+        const std::lock_guard lock{dirty_instances_mutex};
+        dirty_instances.clear(); // we write everything, so anything pending is covered too
+    }
+
     QJsonObject instance_records_json;
     for (const auto& record : vm_instance_specs)
     {
@@ -2728,6 +3143,7 @@ void mp::Daemon::persist_instances()
     QDir data_dir{
         mp::utils::backend_directory_path(config->data_directory, config->factory->get_backend_directory_name())};
     MP_JSONUTILS.write_json(instance_records_json, data_dir.filePath(instance_db_name));
+    instance_journal.reset(instance_records_json);
 }
 
 void mp::Daemon::release_resources(const std::string& instance)
@@ -2735,9 +3151,20 @@ void mp::Daemon::release_resources(const std::string& instance)
     config->vault->remove(instance);
     config->factory->remove_resources_for(instance);
 
+    std::vector<std::unique_ptr<SSHSession>> exec_sessions; // closed outside the lock
+    {
+        const std::lock_guard lock{exec_sessions_mutex};
+        if (auto it = idle_exec_sessions.find(instance); it != idle_exec_sessions.end())
+        {
+            exec_sessions = std::move(it->second);
+            idle_exec_sessions.erase(it);
+        }
+    }
+
     auto spec_it = vm_instance_specs.find(instance);
     if (spec_it != cend(vm_instance_specs))
     {
+        const std::lock_guard lock{allocated_mac_addrs_mutex};
         for (const auto& mac : mac_set_from(spec_it->second))
             allocated_mac_addrs.erase(mac);
 
@@ -3017,7 +3444,10 @@ void mp::Daemon::create_vm(const CreateRequest* request,
             config->factory->prepare_networking(checked_args.extra_interfaces);
 
             // This set stores the MAC's which need to be in the allocated_mac_addrs if everything goes well.
-            auto new_macs = allocated_mac_addrs;
+            auto new_macs = [this] {
+                const std::lock_guard lock{allocated_mac_addrs_mutex};
+                return allocated_mac_addrs;
+            }();
 
             // check for repetition of requested macs
             for (auto& iface : checked_args.extra_interfaces)
@@ -3046,8 +3476,19 @@ void mp::Daemon::create_vm(const CreateRequest* request,
             config->factory->configure(vm_desc);
             config->factory->prepare_instance_image(vm_image, vm_desc);
 
-            // Everything went well, add the MAC addresses used in this instance.
-            allocated_mac_addrs = std::move(new_macs);
+            // Everything went well, add the MAC addresses used in this instance. Other instances may have been
+            // prepared in the meantime, so check they did not pick the same ones.
+            std::unordered_set<std::string> instance_macs{vm_desc.default_mac_address};
+            for (const auto& iface : vm_desc.extra_interfaces)
+                instance_macs.insert(iface.mac_address);
+
+            {
+                const std::lock_guard lock{allocated_mac_addrs_mutex};
+                if (!merge_if_disjoint(instance_macs, allocated_mac_addrs))
+                    throw std::runtime_error(fmt::format("MAC address collision preparing {}, please retry", name));
+
+                allocated_mac_addrs = std::move(instance_macs);
+            }
 
             return VMFullDescription{vm_desc, client_launch_data};
         }
@@ -3060,6 +3501,101 @@ void mp::Daemon::create_vm(const CreateRequest* request,
     prepare_future_watcher->setFuture(QtConcurrent::run(make_vm_description));
 }
 
+void mp::Daemon::launch_batch(const LaunchRequest* request,
+                              grpc::ServerReaderWriterInterface<LaunchReply, LaunchRequest>* server,
+                              std::promise<grpc::Status>* status_promise)
+{
+    struct Batch
+    {
+        explicit Batch(grpc::ServerReaderWriterInterface<LaunchReply, LaunchRequest>* server) : server{server}
+        {
+        }
+
+        SynchronizedServerReaderWriter<LaunchReply, LaunchRequest> server;
+        std::vector<LaunchRequest> requests;
+        std::vector<std::promise<grpc::Status>> outcomes;
+    };
+
+    auto prefix = request->instance_name();
+    if (prefix.empty())
+        prefix = config->blueprint_provider->name_from_blueprint(request->image());
+
+    std::unordered_set<std::string> used_names{preparing_instances};
+    for (const auto* table : {&operative_instances, &deleted_instances})
+        for (const auto& instance : *table)
+            used_names.insert(instance.first);
+
+    auto names = batch_instance_names(prefix, request->count(), *config->name_generator, used_names);
+
+    // Numbered names can be taken already, in which case none of the batch is launched
+    std::vector<std::string> taken_names;
+    std::copy_if(names.cbegin(), names.cend(), std::back_inserter(taken_names), [&used_names](const auto& name) {
+        return used_names.count(name) > 0;
+    });
+    if (!taken_names.empty())
+        return status_promise->set_value(
+            grpc::Status{grpc::StatusCode::INVALID_ARGUMENT,
+                         fmt::format("Instance names already in use: {}", fmt::join(taken_names, ", "))});
+
+    auto batch = std::make_shared<Batch>(server);
+    for (auto& name : names)
+    {
+        auto& instance_request = batch->requests.emplace_back(*request);
+        instance_request.set_instance_name(name);
+        instance_request.clear_count();
+    }
+    batch->outcomes.resize(batch->requests.size());
+
+    // Each instance launch keeps up to two pool threads busy waiting for it to get ready, so the number of concurrent
+    // launches must leave room in the pool for those waits to make progress
+    const auto max_parallelism = std::max(1, (QThreadPool::globalInstance()->maxThreadCount() - 1) / 2);
+    const auto parallelism =
+        std::min(request->parallelism() > 0 ? request->parallelism() : default_launch_parallelism, max_parallelism);
+
+    mpl::log(mpl::Level::info,
+             category,
+             fmt::format("Launching {} instances, up to {} at a time", batch->requests.size(), parallelism));
+
+    // Image resolution and fetching is shared by the vault among concurrent requests for the same image, so each
+    // instance goes through the regular launch path; readiness is reported to the client one instance at a time
+    QtConcurrent::run([this, batch, parallelism, status_promise] {
+        QSemaphore slots{parallelism};
+        std::vector<std::future<grpc::Status>> launches;
+
+        for (std::size_t i = 0; i < batch->requests.size(); ++i)
+        {
+            slots.acquire();
+
+            auto outcome = batch->outcomes[i].get_future();
+            QMetaObject::invokeMethod(this, [this, batch, i] {
+                launch(&batch->requests[i], &batch->server, &batch->outcomes[i]);
+            });
+
+            launches.push_back(std::async(std::launch::async, [&slots, outcome = std::move(outcome)]() mutable {
+                auto status = outcome.get();
+                slots.release();
+                return status;
+            }));
+        }
+
+        auto status = grpc::Status::OK;
+        fmt::memory_buffer errors;
+        for (std::size_t i = 0; i < launches.size(); ++i)
+        {
+            if (auto instance_status = launches[i].get(); !instance_status.ok())
+            {
+                if (status.ok())
+                    status = instance_status;
+
+                add_fmt_to(errors, "{}: {}", batch->requests[i].instance_name(), instance_status.error_message());
+            }
+        }
+
+        status_promise->set_value(
+            status.ok() ? status : grpc::Status{status.error_code(), fmt::to_string(errors), status.error_details()});
+    });
+}
+
 bool mp::Daemon::delete_vm(InstanceTable::iterator vm_it, bool purge, DeleteReply& response)
 {
     auto& [name, instance] = *vm_it;
@@ -3179,7 +3715,44 @@ grpc::Status mp::Daemon::cancel_vm_shutdown(const VirtualMachine& vm)
     return grpc::Status::OK;
 }
 
-grpc::Status mp::Daemon::get_ssh_info_for_vm(VirtualMachine& vm, SSHInfoReply& response)
+std::unique_ptr<mp::SSHSession> mp::Daemon::open_exec_session(VirtualMachine& vm)
+{
+    return std::make_unique<SSHSession>(vm.ssh_hostname(), vm.ssh_port(), vm.ssh_username(), *config->ssh_key_provider);
+}
+
+std::unique_ptr<mp::SSHSession> mp::Daemon::checkout_exec_session(VirtualMachine& vm)
+{
+    for (;;)
+    {
+        std::unique_ptr<SSHSession> session;
+        {
+            const std::lock_guard lock{exec_sessions_mutex};
+            auto it = idle_exec_sessions.find(vm.vm_name);
+            if (it == idle_exec_sessions.end() || it->second.empty())
+                break;
+
+            session = std::move(it->second.back());
+            it->second.pop_back();
+        }
+
+        if (session->is_connected()) // disconnected ones are closed outside the lock
+            return session;
+    }
+
+    return open_exec_session(vm);
+}
+
+void mp::Daemon::checkin_exec_session(const std::string& name, std::unique_ptr<SSHSession> session)
+{
+    if (!session->is_connected())
+        return;
+
+    const std::lock_guard lock{exec_sessions_mutex};
+    if (auto& idle = idle_exec_sessions[name]; idle.size() < max_idle_exec_sessions)
+        idle.push_back(std::move(session));
+}
+
+grpc::Status mp::Daemon::check_ssh_access(VirtualMachine& vm)
 {
     const auto& name = vm.vm_name;
     if (vm.current_state() == VirtualMachine::State::unknown)
@@ -3196,11 +3769,21 @@ grpc::Status mp::Daemon::get_ssh_info_for_vm(VirtualMachine& vm, SSHInfoReply& r
                                         name, name),
                             ""};
 
+    return grpc::Status::OK;
+}
+
+grpc::Status mp::Daemon::get_ssh_info_for_vm(VirtualMachine& vm, SSHInfoReply& response)
+{
+    if (auto status = check_ssh_access(vm); !status.ok())
+        return status;
+
+    const auto& name = vm.vm_name;
     mp::SSHInfo ssh_info;
     ssh_info.set_host(vm.ssh_hostname());
     ssh_info.set_port(vm.ssh_port());
     ssh_info.set_priv_key_base64(config->ssh_key_provider->private_key_as_base64());
     ssh_info.set_username(vm.ssh_username());
+    ssh_info.set_transport_profile(mp::ssh_transport_profile_name(mp::SSHSession::transport_profile()));
     (*response.mutable_ssh_info())[name] = ssh_info;
 
     return grpc::Status::OK;
@@ -3587,7 +4170,10 @@ void mp::Daemon::add_bridged_interface(const std::string& instance_name)
         throw mp::NonAuthorizedBridgeSettingsException("Cannot update instance settings", instance_name, preferred_net);
     }
 
+    std::unique_lock mac_lock{allocated_mac_addrs_mutex};
     mp::NetworkInterface new_if{preferred_net, generate_unused_mac_address(allocated_mac_addrs), true};
+    mac_lock.unlock();
+
     mpl::log(mpl::Level::debug,
              category,
              fmt::format("New interface {{\"{}\", \"{}\", {}}}", new_if.id, new_if.mac_address, new_if.auto_mode));
@@ -20,6 +20,7 @@
 
 #include "daemon_config.h"
 #include "daemon_rpc.h"
+#include "instance_journal.h"
 
 #include <multipass/async_periodic_download_task.h>
 #include <multipass/delayed_shutdown_timer.h>
@@ -30,6 +31,8 @@
 #include <multipass/vm_status_monitor.h>
 
 #include <chrono>
+#include <deque>
+#include <functional>
 #include <future>
 #include <memory>
 #include <mutex>
@@ -43,6 +46,7 @@ namespace multipass
 {
 struct DaemonConfig;
 class SettingsHandler;
+class SSHSession;
 
 class Daemon : public QObject, public multipass::VMStatusMonitor
 {
@@ -51,7 +55,9 @@ public:
     explicit Daemon(std::unique_ptr<const DaemonConfig> config);
     ~Daemon();
 
-    void persist_instances();
+    void persist_instances();                           // rewrites the whole instance database right away
+    void schedule_persist_for(const std::string& name); // persists an instance's record shortly, coalescing requests
+    void flush_instances();                             // persists pending changes, journaling them where possible
 
 protected:
     using InstanceTable = std::unordered_map<std::string, VirtualMachine::ShPtr>;
@@ -102,6 +108,9 @@ public slots:
                           grpc::ServerReaderWriterInterface<SSHInfoReply, SSHInfoRequest>* server,
                           std::promise<grpc::Status>* status_promise);
 
+    virtual void exec(const ExecRequest* request, grpc::ServerReaderWriterInterface<ExecReply, ExecRequest>* server,
+                      std::promise<grpc::Status>* status_promise, std::function<bool()> is_cancelled);
+
     virtual void start(const StartRequest* request, grpc::ServerReaderWriterInterface<StartReply, StartRequest>* server,
                        std::promise<grpc::Status>* status_promise);
 
@@ -149,16 +158,28 @@ public slots:
                          grpc::ServerReaderWriterInterface<RestoreReply, RestoreRequest>* server,
                          std::promise<grpc::Status>* status_promise);
 
+    virtual void clone(const CloneRequest* request,
+                       grpc::ServerReaderWriterInterface<CloneReply, CloneRequest>* server,
+                       std::promise<grpc::Status>* status_promise);
+
 private:
+    void autostart_pending_instances();
     void release_resources(const std::string& instance);
     void create_vm(const CreateRequest* request, grpc::ServerReaderWriterInterface<CreateReply, CreateRequest>* server,
                    std::promise<grpc::Status>* status_promise, bool start);
+    void launch_batch(const LaunchRequest* request,
+                      grpc::ServerReaderWriterInterface<LaunchReply, LaunchRequest>* server,
+                      std::promise<grpc::Status>* status_promise);
     bool delete_vm(InstanceTable::iterator vm_it, bool purge, DeleteReply& response);
     grpc::Status reboot_vm(VirtualMachine& vm);
     grpc::Status shutdown_vm(VirtualMachine& vm, const std::chrono::milliseconds delay);
     grpc::Status switch_off_vm(VirtualMachine& vm);
     grpc::Status cancel_vm_shutdown(const VirtualMachine& vm);
+    grpc::Status check_ssh_access(VirtualMachine& vm);
     grpc::Status get_ssh_info_for_vm(VirtualMachine& vm, SSHInfoReply& response);
+    std::unique_ptr<SSHSession> open_exec_session(VirtualMachine& vm);
+    std::unique_ptr<SSHSession> checkout_exec_session(VirtualMachine& vm);
+    void checkin_exec_session(const std::string& name, std::unique_ptr<SSHSession> session);
 
     void init_mounts(const std::string& name);
     void stop_mounts(const std::string& name);
@@ -205,6 +226,7 @@ private:
     populate_instance_info(VirtualMachine& vm, InfoReply& response, bool runtime_info, bool deleted, bool& have_mounts);
 
     std::unique_ptr<const DaemonConfig> config;
+    InstanceJournal instance_journal;
 
 protected:
     std::unordered_map<std::string, VMSpecs> vm_instance_specs;
@@ -217,8 +239,12 @@ private:
     InstanceTable deleted_instances;
     std::unordered_map<std::string, std::unique_ptr<DelayedShutdownTimer>> delayed_shutdown_instances;
     std::unordered_set<std::string> allocated_mac_addrs;
+    std::mutex allocated_mac_addrs_mutex; // instances can be prepared concurrently
     DaemonRpc daemon_rpc;
     QTimer source_images_maintenance_task;
+    QTimer persist_instances_timer;
+    std::unordered_set<std::string> dirty_instances;
+    std::mutex dirty_instances_mutex;
     multipass::utils::AsyncPeriodicDownloadTask<void> update_manifests_all_task{"fetch manifest periodically",
                                                                                 std::chrono::minutes(15),
                                                                                 std::chrono::seconds(5),
@@ -229,11 +255,17 @@ private:
     std::unordered_map<std::string, QFuture<std::string>> async_running_futures;
     std::mutex start_mutex;
     std::unordered_set<std::string> preparing_instances;
+    std::deque<std::string> pending_autostarts;
     QFuture<void> image_update_future;
     SettingsHandler* instance_mod_handler;
     SettingsHandler* snapshot_mod_handler;
     std::unordered_map<std::string, std::unordered_map<std::string, MountHandler::UPtr>> mounts;
     std::unordered_set<std::string> user_authorized_bridges;
+
+    // Idle sessions for `exec --shared-session`, kept apart from the instances' own so that long-running user commands
+    // never take the sessions that the daemon's own commands need
+    std::unordered_map<std::string, std::vector<std::unique_ptr<SSHSession>>> idle_exec_sessions;
+    std::mutex exec_sessions_mutex;
 };
 } // namespace multipass
 #endif // MULTIPASS_DAEMON_H
@@ -24,6 +24,7 @@
 #include <multipass/settings/custom_setting_spec.h>
 #include <multipass/settings/persistent_settings_handler.h>
 #include <multipass/settings/settings.h>
+#include <multipass/ssh/ssh_session.h>
 #include <multipass/utils.h>
 
 #include <QCoreApplication>
@@ -79,6 +80,51 @@ QString image_mirror_interpreter(QString val)
     return val;
 }
 
+QString image_pool_interpreter(QString val)
+{
+    bool ok;
+    if (const auto size = val.toInt(&ok); !ok || size < 0)
+        throw mp::InvalidSettingException(mp::image_pool_key, val, "Need a non-negative number of images");
+
+    return val;
+}
+
+QString ssh_profile_interpreter(QString val)
+{
+    if (!mp::ssh_transport_profile_from(val.toStdString()))
+        throw mp::InvalidSettingException(mp::ssh_profile_key, val,
+                                          "Invalid SSH profile, valid options are: default, bulk");
+
+    return val;
+}
+
+QString qemu_suspend_mode_interpreter(QString val)
+{
+    if (val != "savevm" && val != "file")
+        throw mp::InvalidSettingException(mp::qemu_suspend_mode_key, val,
+                                          "Invalid suspend mode, valid options are: savevm, file");
+
+    return val;
+}
+
+QString qemu_mount_driver_interpreter(QString val)
+{
+    if (val != "9p" && val != "virtiofs")
+        throw mp::InvalidSettingException(mp::qemu_mount_driver_key, val,
+                                          "Invalid native mount driver, valid options are: 9p, virtiofs");
+
+    return val;
+}
+
+QString qemu_overcommit_interpreter(QString val)
+{
+    if (val != "off" && val != "psi")
+        throw mp::InvalidSettingException(mp::qemu_overcommit_key, val,
+                                          "Invalid memory overcommit policy, valid options are: off, psi");
+
+    return val;
+}
+
 } // namespace
 
 void mp::daemon::monitor_and_quit_on_settings_change() // temporary
@@ -100,6 +146,13 @@ void mp::daemon::register_global_settings_handlers()
         return val.isEmpty() ? val : MP_UTILS.generate_scrypt_hash_for(val);
     }));
     settings.insert(std::make_unique<CustomSettingSpec>(mp::mirror_key, "", image_mirror_interpreter));
+    settings.insert(std::make_unique<CustomSettingSpec>(mp::image_pool_key, "0", image_pool_interpreter));
+    settings.insert(std::make_unique<CustomSettingSpec>(mp::ssh_profile_key, "default", ssh_profile_interpreter));
+    settings.insert(
+        std::make_unique<CustomSettingSpec>(mp::qemu_suspend_mode_key, "savevm", qemu_suspend_mode_interpreter));
+    settings.insert(
+        std::make_unique<CustomSettingSpec>(mp::qemu_mount_driver_key, "9p", qemu_mount_driver_interpreter));
+    settings.insert(std::make_unique<CustomSettingSpec>(mp::qemu_overcommit_key, "off", qemu_overcommit_interpreter));
 
     MP_SETTINGS.register_handler(
         std::make_unique<PersistentSettingsHandler>(persistent_settings_filename(), std::move(settings)));
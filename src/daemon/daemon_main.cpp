@@ -25,6 +25,8 @@
 #include <multipass/constants.h>
 #include <multipass/logging/log.h>
 #include <multipass/platform_unix.h>
+#include <multipass/settings/settings.h>
+#include <multipass/ssh/ssh_session.h>
 #include <multipass/top_catch_all.h>
 #include <multipass/utils.h>
 #include <multipass/version.h>
@@ -78,6 +80,10 @@ int main_impl(int argc, char* argv[])
 
     mp::daemon::register_global_settings_handlers();
 
+    // the daemon restarts on settings changes, so the SSH profile only needs to be applied once
+    const auto ssh_profile = mp::ssh_transport_profile_from(MP_SETTINGS.get(mp::ssh_profile_key).toStdString());
+    mp::SSHSession::set_transport_profile(ssh_profile.value_or(mp::SSHTransportProfile::standard));
+
     auto builder = mp::cli::parse(app);
     auto config = builder.build();
     auto server_address = config->server_address;
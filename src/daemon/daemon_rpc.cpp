@@ -240,6 +240,17 @@ grpc::Status mp::DaemonRpc::ssh_info(grpc::ServerContext* context,
         std::bind(&DaemonRpc::on_ssh_info, this, &request, server, std::placeholders::_1), client_cert_from(context));
 }
 
+grpc::Status mp::DaemonRpc::exec(grpc::ServerContext* context, grpc::ServerReaderWriter<ExecReply, ExecRequest>* server)
+{
+    ExecRequest request;
+    server->Read(&request);
+
+    auto is_cancelled = [context] { return context->IsCancelled(); };
+    return verify_client_and_dispatch_operation(
+        std::bind(&DaemonRpc::on_exec, this, &request, server, std::placeholders::_1, is_cancelled),
+        client_cert_from(context));
+}
+
 grpc::Status mp::DaemonRpc::start(grpc::ServerContext* context,
                                   grpc::ServerReaderWriter<StartReply, StartRequest>* server)
 {
@@ -394,6 +405,16 @@ grpc::Status mp::DaemonRpc::restore(grpc::ServerContext* context,
         client_cert_from(context));
 }
 
+grpc::Status mp::DaemonRpc::clone(grpc::ServerContext* context,
+                                  grpc::ServerReaderWriter<CloneReply, CloneRequest>* server)
+{
+    CloneRequest request;
+    server->Read(&request);
+
+    return verify_client_and_dispatch_operation(
+        std::bind(&DaemonRpc::on_clone, this, &request, server, std::placeholders::_1), client_cert_from(context));
+}
+
 template <typename OperationSignal>
 grpc::Status mp::DaemonRpc::verify_client_and_dispatch_operation(OperationSignal signal, const std::string& client_cert)
 {
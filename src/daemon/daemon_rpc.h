@@ -28,6 +28,7 @@
 
 #include <QObject>
 
+#include <functional>
 #include <future>
 #include <memory>
 
@@ -77,6 +78,8 @@ signals:
                     std::promise<grpc::Status>* status_promise);
     void on_ssh_info(const SSHInfoRequest* request, grpc::ServerReaderWriter<SSHInfoReply, SSHInfoRequest>* server,
                      std::promise<grpc::Status>* status_promise);
+    void on_exec(const ExecRequest* request, grpc::ServerReaderWriter<ExecReply, ExecRequest>* server,
+                 std::promise<grpc::Status>* status_promise, std::function<bool()> is_cancelled);
     void on_start(const StartRequest* request, grpc::ServerReaderWriter<StartReply, StartRequest>* server,
                   std::promise<grpc::Status>* status_promise);
     void on_stop(const StopRequest* request, grpc::ServerReaderWriter<StopReply, StopRequest>* server,
@@ -106,6 +109,9 @@ signals:
     void on_restore(const RestoreRequest* request,
                     grpc::ServerReaderWriter<RestoreReply, RestoreRequest>* server,
                     std::promise<grpc::Status>* status_promise);
+    void on_clone(const CloneRequest* request,
+                  grpc::ServerReaderWriter<CloneReply, CloneRequest>* server,
+                  std::promise<grpc::Status>* status_promise);
 
 private:
     template <typename OperationSignal>
@@ -134,6 +140,7 @@ protected:
                          grpc::ServerReaderWriter<RecoverReply, RecoverRequest>* server) override;
     grpc::Status ssh_info(grpc::ServerContext* context,
                           grpc::ServerReaderWriter<SSHInfoReply, SSHInfoRequest>* server) override;
+    grpc::Status exec(grpc::ServerContext* context, grpc::ServerReaderWriter<ExecReply, ExecRequest>* server) override;
     grpc::Status start(grpc::ServerContext* context,
                        grpc::ServerReaderWriter<StartReply, StartRequest>* server) override;
     grpc::Status stop(grpc::ServerContext* context, grpc::ServerReaderWriter<StopReply, StopRequest>* server) override;
@@ -157,6 +164,8 @@ protected:
                           grpc::ServerReaderWriter<SnapshotReply, SnapshotRequest>* server) override;
     grpc::Status restore(grpc::ServerContext* context,
                          grpc::ServerReaderWriter<RestoreReply, RestoreRequest>* server) override;
+    grpc::Status clone(grpc::ServerContext* context,
+                       grpc::ServerReaderWriter<CloneReply, CloneRequest>* server) override;
 };
 } // namespace multipass
 #endif // MULTIPASS_DAEMON_RPC_H
@@ -38,8 +38,10 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QUrl>
+#include <QUuid>
 #include <QtConcurrent/QtConcurrent>
 
+#include <algorithm>
 #include <exception>
 
 namespace mp = multipass;
@@ -50,6 +52,34 @@ namespace
 constexpr auto category = "image vault";
 constexpr auto instance_db_name = "multipassd-instance-image-records.json";
 constexpr auto image_db_name = "multipassd-image-records.json";
+constexpr auto pooled_image_suffix = ".img";
+constexpr auto partial_pooled_image_suffix = ".partial";
+constexpr qint64 pool_copy_chunk_size = 8LL << 20; // unit: bytes
+
+// Unlike QFile::copy, this gives up in the middle of a multi-GB image as soon as it is cancelled
+bool copy_unless_cancelled(const QString& source_path,
+                           const QString& destination_path,
+                           const std::atomic_bool& cancelled)
+{
+    QFile source{source_path};
+    QFile destination{destination_path};
+    if (!source.open(QIODevice::ReadOnly) || !destination.open(QIODevice::WriteOnly) ||
+        !destination.setPermissions(source.permissions()))
+        return false;
+
+    QByteArray chunk(pool_copy_chunk_size, Qt::Uninitialized);
+    while (!cancelled)
+    {
+        const auto read = source.read(chunk.data(), chunk.size());
+        if (read <= 0)
+            return read == 0 && destination.flush();
+
+        if (destination.write(chunk.constData(), read) != read)
+            return false;
+    }
+
+    return false;
+}
 
 auto query_to_json(const mp::Query& query)
 {
@@ -219,6 +249,12 @@ mp::MemorySize get_image_size(const mp::Path& image_path)
     return image_size;
 }
 
+QFileInfoList pooled_images_in(const QDir& pool_dir)
+{
+    // a fresh QDir, so that the listing is not a cached one
+    return QDir{pool_dir.path()}.entryInfoList({QString{"*"} + pooled_image_suffix}, QDir::Files, QDir::Name);
+}
+
 template <typename T>
 void persist_records(const T& records, const QString& path)
 {
@@ -236,13 +272,16 @@ mp::DefaultVMImageVault::DefaultVMImageVault(std::vector<VMImageHost*> image_hos
                                              URLDownloader* downloader,
                                              const mp::Path& cache_dir_path,
                                              const mp::Path& data_dir_path,
-                                             const mp::days& days_to_expire)
+                                             const mp::days& days_to_expire,
+                                             int image_pool_size)
     : BaseVMImageVault{image_hosts},
       url_downloader{downloader},
       cache_dir{QDir(cache_dir_path).filePath("vault")},
       data_dir{QDir(data_dir_path).filePath("vault")},
       images_dir(cache_dir.filePath("images")),
       days_to_expire{days_to_expire},
+      pools_dir{data_dir.filePath("pools")},
+      image_pool_size{image_pool_size},
       prepared_image_records{load_db(cache_dir.filePath(image_db_name))},
       instance_image_records{load_db(data_dir.filePath(instance_db_name))}
 {
@@ -251,6 +290,15 @@ mp::DefaultVMImageVault::DefaultVMImageVault(std::vector<VMImageHost*> image_hos
 mp::DefaultVMImageVault::~DefaultVMImageVault()
 {
     url_downloader->abort_all_downloads();
+
+    // copies into the pools stop at the next chunk, so this does not wait on whole images
+    for (auto& [_, refill] : pool_refills)
+        *refill.cancelled = true;
+
+    for (auto& [_, refill] : pool_refills)
+        refill.future.waitForFinished();
+    for (auto& refill : cancelled_pool_refills)
+        refill.waitForFinished();
 }
 
 mp::VMImage mp::DefaultVMImageVault::fetch_image(const FetchType& fetch_type,
@@ -454,6 +502,38 @@ void mp::DefaultVMImageVault::remove(const std::string& name)
     persist_instance_records();
 }
 
+mp::VMImage mp::DefaultVMImageVault::clone(const std::string& source_name,
+                                           const std::string& destination_name,
+                                           const mp::Path& destination_dir)
+{
+    std::lock_guard<decltype(fetch_mutex)> lock{fetch_mutex};
+
+    const auto source_entry = instance_image_records.find(source_name);
+    if (source_entry == instance_image_records.end())
+        throw std::runtime_error(fmt::format("No instance image found for {}", source_name));
+
+    if (instance_image_records.find(destination_name) != instance_image_records.end())
+        throw std::runtime_error(fmt::format("An instance image already exists for {}", destination_name));
+
+    MP_UTILS.make_dir(destination_dir);
+
+    // QFile::copy clones the file where the filesystem supports it (e.g. reflinks on btrfs or XFS), so this is
+    // usually cheap regardless of the image size
+    auto record = source_entry->second;
+    const auto image_path = QDir{destination_dir}.filePath(mp::vault::filename_for(record.image.image_path));
+    if (!QFile::copy(record.image.image_path, image_path))
+        throw std::runtime_error(fmt::format("Could not copy {} to {}", record.image.image_path, image_path));
+
+    record.image.image_path = image_path;
+    record.query.name = destination_name;
+    record.last_accessed = std::chrono::system_clock::now();
+
+    const auto& [entry, _] = instance_image_records.insert_or_assign(destination_name, std::move(record));
+    persist_instance_records();
+
+    return entry->second.image;
+}
+
 bool mp::DefaultVMImageVault::has_record_for(const std::string& name)
 {
     return instance_image_records.find(name) != instance_image_records.end();
@@ -497,6 +577,7 @@ void mp::DefaultVMImageVault::prune_expired_images()
         prepared_image_records.erase(key);
 
     persist_image_records();
+    remove_stale_pools();
 }
 
 void mp::DefaultVMImageVault::update_images(const FetchType& fetch_type, const PrepareAction& prepare,
@@ -551,6 +632,7 @@ void mp::DefaultVMImageVault::update_images(const FetchType& fetch_type, const P
             delete_image_dir(record.image.image_path);
             prepared_image_records.erase(key);
             persist_image_records();
+            remove_stale_pools();
         }
         catch (const CreateImageException& e)
         {
@@ -665,6 +747,108 @@ mp::VMImage mp::DefaultVMImageVault::image_instance_from(const VMImage& prepared
             {}};
 }
 
+// Called with fetch_mutex held
+std::optional<mp::VMImage> mp::DefaultVMImageVault::claim_pooled_image(const VMImage& prepared_image,
+                                                                       const std::string& id,
+                                                                       const mp::Path& dest_dir)
+{
+    if (image_pool_size <= 0)
+        return std::nullopt;
+
+    for (const auto& pooled_image : pooled_images_in(pools_dir.filePath(QString::fromStdString(id))))
+    {
+        MP_UTILS.make_dir(dest_dir);
+
+        const auto image_path = QDir{dest_dir}.filePath(QFileInfo{prepared_image.image_path}.fileName());
+        if (QFile::rename(pooled_image.absoluteFilePath(), image_path))
+        {
+            mpl::log(mpl::Level::debug, category, fmt::format("Using pooled instance image for {}", image_path));
+            return VMImage{image_path,
+                           prepared_image.id,
+                           prepared_image.original_release,
+                           prepared_image.current_release,
+                           prepared_image.release_date,
+                           {}};
+        }
+
+        mpl::log(mpl::Level::warning, category,
+                 fmt::format("Cannot use pooled instance image {}", pooled_image.absoluteFilePath()));
+    }
+
+    return std::nullopt;
+}
+
+// Called with fetch_mutex held
+void mp::DefaultVMImageVault::refill_pool(const VMImage& prepared_image, const std::string& id)
+{
+    if (image_pool_size <= 0)
+        return;
+
+    if (auto it = pool_refills.find(id); it != pool_refills.end() && !it->second.future.isFinished())
+        return;
+
+    auto cancelled = std::make_shared<std::atomic_bool>(false);
+    auto future = QtConcurrent::run(&DefaultVMImageVault::fill_pool,
+                                    this,
+                                    prepared_image.image_path,
+                                    QDir{pools_dir.filePath(QString::fromStdString(id))},
+                                    std::shared_ptr<const std::atomic_bool>{cancelled});
+    pool_refills[id] = {std::move(future), std::move(cancelled)};
+}
+
+void mp::DefaultVMImageVault::fill_pool(const QString& image_path,
+                                        const QDir& pool_dir,
+                                        std::shared_ptr<const std::atomic_bool> cancelled)
+{
+    MP_UTILS.make_dir(pool_dir);
+
+    // left behind if the daemon stopped in the middle of a copy
+    for (const auto& partial : pool_dir.entryInfoList({QString{"*"} + partial_pooled_image_suffix}, QDir::Files))
+        QFile::remove(partial.absoluteFilePath());
+
+    while (!*cancelled && pooled_images_in(pool_dir).size() < image_pool_size)
+    {
+        // copied under another name first, so that only complete images can be claimed
+        const auto pooled_path = pool_dir.filePath(QUuid::createUuid().toString(QUuid::WithoutBraces));
+        if (!copy_unless_cancelled(image_path, pooled_path + partial_pooled_image_suffix, *cancelled) ||
+            !QFile::rename(pooled_path + partial_pooled_image_suffix, pooled_path + pooled_image_suffix))
+        {
+            QFile::remove(pooled_path + partial_pooled_image_suffix);
+            if (!*cancelled)
+                mpl::log(mpl::Level::warning, category,
+                         fmt::format("Cannot add a copy of {} to the instance image pool", image_path));
+            return;
+        }
+    }
+}
+
+// Called with fetch_mutex held
+void mp::DefaultVMImageVault::remove_stale_pools()
+{
+    cancelled_pool_refills.erase(std::remove_if(cancelled_pool_refills.begin(),
+                                                cancelled_pool_refills.end(),
+                                                [](const auto& refill) { return refill.isFinished(); }),
+                                 cancelled_pool_refills.end());
+
+    for (const auto& pool : pools_dir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot))
+    {
+        const auto id = pool.fileName().toStdString();
+        if (prepared_image_records.find(id) != prepared_image_records.end())
+            continue;
+
+        // the refill gives up on its own, without holding up whoever holds fetch_mutex
+        if (auto it = pool_refills.find(id); it != pool_refills.end())
+        {
+            *it->second.cancelled = true;
+            cancelled_pool_refills.push_back(std::move(it->second.future));
+            pool_refills.erase(it);
+        }
+
+        mpl::log(mpl::Level::debug, category, fmt::format("Removing instance image pool for {}", id));
+        QDir{pool.absoluteFilePath()}.removeRecursively();
+    }
+}
+
 std::optional<QFuture<mp::VMImage>> mp::DefaultVMImageVault::get_image_future(const std::string& id)
 {
     auto it = in_progress_image_fetches.find(id);
@@ -685,8 +869,10 @@ mp::VMImage mp::DefaultVMImageVault::finalize_image_records(const Query& query,
 
     if (!query.name.empty())
     {
-        vm_image = image_instance_from(prepared_image, dest_dir);
+        auto pooled_image = claim_pooled_image(prepared_image, id, dest_dir);
+        vm_image = pooled_image ? *pooled_image : image_instance_from(prepared_image, dest_dir);
         instance_image_records[query.name] = {vm_image, query, std::chrono::system_clock::now()};
+        refill_pool(prepared_image, id);
     }
 
     // Do not save the instance name for prepared images
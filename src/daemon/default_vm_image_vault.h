@@ -27,9 +27,12 @@
 #include <QDir>
 #include <QFuture>
 
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <unordered_map>
+#include <vector>
 
 namespace multipass
 {
@@ -49,7 +52,8 @@ public:
                         URLDownloader* downloader,
                         const multipass::Path& cache_dir_path,
                         const multipass::Path& data_dir_path,
-                        const multipass::days& days_to_expire);
+                        const multipass::days& days_to_expire,
+                        int image_pool_size = 0);
     ~DefaultVMImageVault();
 
     VMImage fetch_image(const FetchType& fetch_type,
@@ -60,6 +64,9 @@ public:
                         const std::optional<std::string>& checksum,
                         const Path& save_dir) override;
     void remove(const std::string& name) override;
+    VMImage clone(const std::string& source_name,
+                  const std::string& destination_name,
+                  const Path& destination_dir) override;
     bool has_record_for(const std::string& name) override;
     void prune_expired_images() override;
     void update_images(const FetchType& fetch_type, const PrepareAction& prepare,
@@ -68,6 +75,11 @@ public:
 
 private:
     VMImage image_instance_from(const VMImage& prepared_image, const Path& dest_dir);
+    std::optional<VMImage> claim_pooled_image(const VMImage& prepared_image, const std::string& id,
+                                              const Path& dest_dir);
+    void refill_pool(const VMImage& prepared_image, const std::string& id);
+    void fill_pool(const QString& image_path, const QDir& pool_dir, std::shared_ptr<const std::atomic_bool> cancelled);
+    void remove_stale_pools();
     VMImage download_and_prepare_source_image(const VMImageInfo& info, std::optional<VMImage>& existing_source_image,
                                               const QDir& image_dir, const FetchType& fetch_type,
                                               const PrepareAction& prepare, const ProgressMonitor& monitor);
@@ -85,11 +97,20 @@ private:
     const QDir data_dir;
     const QDir images_dir;
     const days days_to_expire;
+    const QDir pools_dir;
+    const int image_pool_size; // instance images kept ready per source image, so launching only needs to move one
     std::mutex fetch_mutex;
 
     std::unordered_map<std::string, VaultRecord> prepared_image_records;
     std::unordered_map<std::string, VaultRecord> instance_image_records;
     std::unordered_map<std::string, QFuture<VMImage>> in_progress_image_fetches;
+    struct PoolRefill
+    {
+        QFuture<void> future;
+        std::shared_ptr<std::atomic_bool> cancelled; // checked between chunks of each copy
+    };
+    std::unordered_map<std::string, PoolRefill> pool_refills;
+    std::vector<QFuture<void>> cancelled_pool_refills; // of removed pools, only waited for on destruction
 };
 } // namespace multipass
 #endif // MULTIPASS_DEFAULT_VM_IMAGE_VAULT_H
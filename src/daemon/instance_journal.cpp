@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "instance_journal.h"
+
+#include <multipass/format.h>
+#include <multipass/logging/log.h>
+#include <multipass/posix.h>
+
+#include <QCborMap>
+#include <QCborValue>
+#include <QCryptographicHash>
+#include <QFile>
+#include <QJsonDocument>
+#include <QtEndian>
+
+#include <iterator>
+#include <vector>
+
+namespace mp = multipass;
+namespace mpl = multipass::logging;
+
+namespace
+{
+constexpr auto category = "instance journal";
+constexpr auto base_key = "base";
+constexpr auto records_key = "records";
+
+QByteArray hash_of(const QJsonObject& base)
+{
+    return QCryptographicHash::hash(QJsonDocument{base}.toJson(QJsonDocument::Compact), QCryptographicHash::Sha256);
+}
+
+// Each entry is a CBOR map, preceded by its size as a 32-bit big-endian integer
+QByteArray frame(const QCborMap& entry)
+{
+    const auto payload = entry.toCborValue().toCbor();
+    const auto size = qToBigEndian(static_cast<quint32>(payload.size()));
+
+    return QByteArray{reinterpret_cast<const char*>(&size), sizeof(size)} + payload;
+}
+
+// Reads entries until the end of the file or the first incomplete/corrupt one (e.g. a write torn by a crash)
+std::vector<QCborMap> read_entries(QFile& file)
+{
+    std::vector<QCborMap> entries;
+
+    quint32 size;
+    while (file.read(reinterpret_cast<char*>(&size), sizeof(size)) == sizeof(size))
+    {
+        size = qFromBigEndian(size);
+        const auto payload = file.read(size);
+        if (static_cast<quint32>(payload.size()) != size)
+            break;
+
+        QCborParserError error;
+        const auto value = QCborValue::fromCbor(payload, &error);
+        if (error.error != QCborError::NoError || !value.isMap())
+            break;
+
+        entries.push_back(value.toMap());
+    }
+
+    return entries;
+}
+
+// flush() only hands the data to the kernel; appends need to be as durable as the whole-file writes they stand in for
+bool sync_to_disk(QFile& file)
+{
+#ifdef MULTIPASS_PLATFORM_WINDOWS
+    return ::_commit(file.handle()) == 0;
+#else
+    return ::fsync(file.handle()) == 0;
+#endif
+}
+} // namespace
+
+mp::InstanceJournal::InstanceJournal(const QString& file_path) : file_path{file_path}
+{
+}
+
+QJsonObject mp::InstanceJournal::replay(QJsonObject base)
+{
+    const std::lock_guard lock{mutex};
+
+    base_hash = hash_of(base);
+    num_entries = 0;
+
+    QFile file{file_path};
+    if (!file.open(QIODevice::ReadOnly))
+        return base;
+
+    const auto entries = read_entries(file);
+    file.close();
+
+    if (entries.empty() || entries.front()[QLatin1String(base_key)].toByteArray() != *base_hash)
+    {
+        mpl::log(mpl::Level::debug, category, fmt::format("Discarding stale journal: {}", file_path));
+        remove_file();
+        return base;
+    }
+
+    for (auto it = std::next(entries.cbegin()); it != entries.cend(); ++it)
+    {
+        const auto records = (*it)[QLatin1String(records_key)].toMap().toJsonObject();
+        for (auto record = records.constBegin(); record != records.constEnd(); ++record)
+            base.insert(record.key(), record.value());
+
+        ++num_entries;
+    }
+
+    if (!num_entries)
+        remove_file(); // nothing worth keeping; we want appends to start over
+
+    mpl::log(mpl::Level::debug, category, fmt::format("Replayed {} journal entries from {}", num_entries, file_path));
+
+    return base;
+}
+
+bool mp::InstanceJournal::append(const QJsonObject& records)
+{
+    const std::lock_guard lock{mutex};
+
+    if (!base_hash)
+        return false;
+
+    QFile file{file_path};
+    const auto fresh = !file.exists();
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+    {
+        mpl::log(mpl::Level::warning,
+                 category,
+                 fmt::format("Could not open journal {} for writing: {}", file_path, file.errorString()));
+        return false;
+    }
+
+    QByteArray data;
+    if (fresh)
+        data += frame(QCborMap{{QLatin1String(base_key), *base_hash}});
+    data += frame(QCborMap{{QLatin1String(records_key), QCborMap::fromJsonObject(records)}});
+
+    if (file.write(data) != data.size() || !file.flush() || !sync_to_disk(file))
+    {
+        mpl::log(mpl::Level::warning,
+                 category,
+                 fmt::format("Could not write to journal {}: {}", file_path, file.errorString()));
+        file.close();
+        remove_file(); // don't leave a torn entry behind, as it would hide anything appended after it
+        return false;
+    }
+
+    ++num_entries;
+    return true;
+}
+
+void mp::InstanceJournal::reset(const QJsonObject& base)
+{
+    const std::lock_guard lock{mutex};
+
+    base_hash = hash_of(base);
+    num_entries = 0;
+    remove_file();
+}
+
+int mp::InstanceJournal::size() const
+{
+    const std::lock_guard lock{mutex};
+    return num_entries;
+}
+
+void mp::InstanceJournal::remove_file()
+{
+    if (QFile::exists(file_path) && !QFile::remove(file_path))
+    {
+        mpl::log(mpl::Level::warning, category, fmt::format("Could not remove journal {}", file_path));
+        base_hash.reset(); // appending to the old file would be lost on replay, so refuse it
+    }
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef MULTIPASS_INSTANCE_JOURNAL_H
+#define MULTIPASS_INSTANCE_JOURNAL_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QString>
+
+#include <mutex>
+#include <optional>
+
+namespace multipass
+{
+// Append-only log of instance records, kept next to the instance database. It allows persisting a few changed records
+// without rewriting the whole database. Entries are binary (CBOR) and only apply on top of the exact database contents
+// they were logged against (the base), so a journal that outlived a database rewrite is recognized as stale.
+class InstanceJournal
+{
+public:
+    explicit InstanceJournal(const QString& file_path);
+
+    // Returns base with the logged records applied, adopting base as the current base. Stale entries are discarded.
+    QJsonObject replay(QJsonObject base);
+
+    // Logs records (instance name -> record) on top of the current base. Returns whether that was possible; if not,
+    // the caller needs to rewrite the database and reset the journal.
+    bool append(const QJsonObject& records);
+
+    // Starts an empty journal on top of base, which must already be written to the database.
+    void reset(const QJsonObject& base);
+
+    // The number of entries logged on top of the current base.
+    int size() const;
+
+private:
+    void remove_file();
+
+    const QString file_path;
+    mutable std::mutex mutex;
+    std::optional<QByteArray> base_hash = std::nullopt;
+    int num_entries = 0;
+};
+} // namespace multipass
+
+#endif // MULTIPASS_INSTANCE_JOURNAL_H
@@ -34,6 +34,8 @@ constexpr auto cpus_suffix = "cpus";
 constexpr auto mem_suffix = "memory";
 constexpr auto disk_suffix = "disk";
 constexpr auto bridged_suffix = "bridged";
+constexpr auto disk_profile_suffix = "disk-profile";
+constexpr auto memory_profile_suffix = "memory-profile";
 
 enum class Operation
 {
@@ -50,7 +52,9 @@ QRegularExpression make_key_regex()
 {
     const auto instance_pattern = QStringLiteral("(?<instance>.+)");
     const auto prop_template = QStringLiteral("(?<property>%1)");
-    const auto either_prop = QStringList{cpus_suffix, mem_suffix, disk_suffix, bridged_suffix}.join("|");
+    const auto either_prop =
+        QStringList{cpus_suffix, mem_suffix, disk_suffix, bridged_suffix, disk_profile_suffix, memory_profile_suffix}
+            .join("|");
     const auto prop_pattern = prop_template.arg(either_prop);
 
     const auto key_template = QStringLiteral(R"(%1\.%2\.%3)");
@@ -157,6 +161,40 @@ void update_disk(const QString& key, const QString& val, mp::VirtualMachine& ins
     }
 }
 
+void update_disk_profile(const QString& key, const QString& val, mp::VirtualMachine& instance, mp::VMSpecs& spec)
+{
+    if (auto profile = val.toStdString(); profile != spec.disk_profile) // NOOP if equal
+    {
+        try
+        {
+            instance.update_disk_profile(profile);
+        }
+        catch (const std::invalid_argument& e)
+        {
+            throw mp::InvalidSettingException{key, val, e.what()};
+        }
+
+        spec.disk_profile = profile;
+    }
+}
+
+void update_memory_profile(const QString& key, const QString& val, mp::VirtualMachine& instance, mp::VMSpecs& spec)
+{
+    if (auto profile = val.toStdString(); profile != spec.memory_profile) // NOOP if equal
+    {
+        try
+        {
+            instance.update_memory_profile(profile);
+        }
+        catch (const std::invalid_argument& e)
+        {
+            throw mp::InvalidSettingException{key, val, e.what()};
+        }
+
+        spec.memory_profile = profile;
+    }
+}
+
 void update_bridged(const QString& key,
                     const QString& val,
                     const std::string& instance_name,
@@ -204,7 +242,8 @@ std::set<QString> mp::InstanceSettingsHandler::keys() const
 
     std::set<QString> ret;
     for (const auto& item : vm_instance_specs)
-        for (const auto& suffix : {cpus_suffix, mem_suffix, disk_suffix, bridged_suffix})
+        for (const auto& suffix :
+             {cpus_suffix, mem_suffix, disk_suffix, bridged_suffix, disk_profile_suffix, memory_profile_suffix})
             ret.insert(key_template.arg(item.first.c_str()).arg(suffix));
 
     return ret;
@@ -221,6 +260,10 @@ QString mp::InstanceSettingsHandler::get(const QString& key) const
     }
     if (property == cpus_suffix)
         return QString::number(spec.num_cores);
+    if (property == disk_profile_suffix)
+        return QString::fromStdString(spec.disk_profile);
+    if (property == memory_profile_suffix)
+        return QString::fromStdString(spec.memory_profile);
     if (property == mem_suffix)
         return QString::fromStdString(spec.mem_size.human_readable()); /* TODO return in bytes when --raw
                                                                           (need unmarshall capability, w/ flag) */
@@ -246,6 +289,10 @@ void mp::InstanceSettingsHandler::set(const QString& key, const QString& val)
     {
         update_bridged(key, val, instance_name, is_bridged, add_interface);
     }
+    else if (property == disk_profile_suffix)
+        update_disk_profile(key, val, instance, spec);
+    else if (property == memory_profile_suffix)
+        update_memory_profile(key, val, instance, spec);
     else
     {
         auto size = get_memory_size(key, val);
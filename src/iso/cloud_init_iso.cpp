@@ -705,14 +705,17 @@ void mp::CloudInitFileOps::update_cloud_init_with_new_extra_interfaces_and_new_i
     const std::string& default_mac_addr,
     const std::vector<NetworkInterface>& extra_interfaces,
     const std::string& new_instance_id,
+    const std::string& new_hostname,
     const std::filesystem::path& cloud_init_path) const
 {
     CloudInitIso iso_file;
     iso_file.read_from(cloud_init_path);
 
     std::string& meta_data_file_content = iso_file.at("meta-data");
-    meta_data_file_content =
-        mpu::emit_cloud_config(mpu::make_cloud_init_meta_config_with_id_tweak(meta_data_file_content, new_instance_id));
+    auto meta_data = mpu::make_cloud_init_meta_config_with_id_tweak(meta_data_file_content, new_instance_id);
+    if (!new_hostname.empty())
+        meta_data["local-hostname"] = new_hostname;
+    meta_data_file_content = mpu::emit_cloud_config(meta_data);
 
     if (extra_interfaces.empty())
     {
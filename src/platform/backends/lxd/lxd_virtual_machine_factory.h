@@ -49,6 +49,7 @@ public:
                                           const Path& cache_dir_path, const Path& data_dir_path,
                                           const days& days_to_expire) override;
     void configure(VirtualMachineDescription& vm_desc) override;
+    void prepare_clone(const std::string& source_name, VirtualMachineDescription& vm_desc) override;
     std::vector<NetworkInterfaceInfo> networks() const override;
     void require_suspend_support() const override;
 
@@ -68,4 +69,10 @@ inline void multipass::LXDVirtualMachineFactory::require_suspend_support() const
     throw NotImplementedOnThisBackendException{"suspend"};
 }
 
+inline void multipass::LXDVirtualMachineFactory::prepare_clone(const std::string& source_name,
+                                                               VirtualMachineDescription& vm_desc)
+{
+    throw NotImplementedOnThisBackendException{"clone"};
+}
+
 #endif // MULTIPASS_LXD_VIRTUAL_MACHINE_FACTORY_H
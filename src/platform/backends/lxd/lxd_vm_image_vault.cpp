@@ -21,6 +21,7 @@
 #include <multipass/exceptions/aborted_download_exception.h>
 #include <multipass/exceptions/image_vault_exceptions.h>
 #include <multipass/exceptions/local_socket_connection_exception.h>
+#include <multipass/exceptions/not_implemented_on_this_backend_exception.h>
 #include <multipass/format.h>
 #include <multipass/logging/log.h>
 #include <multipass/network_access_manager.h>
@@ -346,6 +347,13 @@ void mp::LXDVMImageVault::remove(const std::string& name)
     }
 }
 
+mp::VMImage mp::LXDVMImageVault::clone(const std::string& source_name,
+                                       const std::string& destination_name,
+                                       const mp::Path& destination_dir)
+{
+    throw NotImplementedOnThisBackendException{"clone"};
+}
+
 bool mp::LXDVMImageVault::has_record_for(const std::string& name)
 {
     try
@@ -47,6 +47,9 @@ public:
                         const std::optional<std::string>& checksum,
                         const Path& /* save_dir */) override;
     void remove(const std::string& name) override;
+    VMImage clone(const std::string& source_name,
+                  const std::string& destination_name,
+                  const Path& destination_dir) override;
     bool has_record_for(const std::string& name) override;
     void prune_expired_images() override;
     void update_images(const FetchType& fetch_type, const PrepareAction& prepare,
@@ -25,6 +25,7 @@
 #include <shared/linux/process_factory.h>
 
 #include <QDir>
+#include <QFileInfo>
 
 #include <fstream>
 
@@ -47,7 +48,8 @@ mp::DNSMasqServer::DNSMasqServer(const Path& data_dir, const QString& bridge_nam
     : data_dir{data_dir},
       bridge_name{bridge_name},
       subnet{subnet},
-      conf_file{QDir(data_dir).absoluteFilePath("dnsmasq-XXXXXX.conf")}
+      conf_file{QDir(data_dir).absoluteFilePath("dnsmasq-XXXXXX.conf")},
+      leases_path{QDir(data_dir).filePath("dnsmasq.leases")}
 {
     conf_file.open();
     conf_file.close();
@@ -60,6 +62,7 @@ mp::DNSMasqServer::DNSMasqServer(const Path& data_dir, const QString& bridge_nam
 
     dnsmasq_cmd = make_dnsmasq_process(data_dir, bridge_name, subnet, conf_file.fileName());
     start_dnsmasq();
+    watch_leases();
 }
 
 mp::DNSMasqServer::~DNSMasqServer()
@@ -84,21 +87,21 @@ mp::DNSMasqServer::~DNSMasqServer()
 
 std::optional<mp::IPAddress> mp::DNSMasqServer::get_ip_for(const std::string& hw_addr)
 {
-    // DNSMasq leases entries consist of:
-    // <lease expiration> <mac addr> <ipv4> <name> * * *
-    const auto path = QDir(data_dir).filePath("dnsmasq.leases").toStdString();
-    const std::string delimiter{" "};
-    const int hw_addr_idx{1};
-    const int ipv4_idx{2};
-    std::ifstream leases_file{path};
-    std::string line;
-    while (getline(leases_file, line))
-    {
-        const auto fields = mp::utils::split(line, delimiter);
-        if (fields.size() > 2 && fields[hw_addr_idx] == hw_addr)
-            return fields[ipv4_idx];
-    }
-    return std::nullopt;
+    std::lock_guard lock{leases_mutex};
+
+    if (leases_stale.exchange(false))
+        load_leases();
+
+    // The watcher's notifications are only processed in the event loop, so check for new leases on misses, to pick up
+    // instances that are just getting their address
+    auto it = leases.find(hw_addr);
+    if (it == leases.end() && load_leases_if_changed())
+        it = leases.find(hw_addr);
+
+    if (it == leases.end())
+        return std::nullopt;
+
+    return it->second;
 }
 
 void mp::DNSMasqServer::release_mac(const std::string& hw_addr)
@@ -132,6 +135,59 @@ void mp::DNSMasqServer::release_mac(const std::string& hw_addr)
                                                      << QString::fromStdString(hw_addr));
 
     dhcp_release.waitForFinished();
+    std::lock_guard lock{leases_mutex};
+    leases.erase(hw_addr);
+}
+
+void mp::DNSMasqServer::watch_leases()
+{
+    // dnsmasq may replace the leases file rather than modify it, so watch the directory too and re-add the file
+    auto on_change = [this] {
+        leases_stale = true;
+        if (QFile::exists(leases_path) && !leases_watcher.files().contains(leases_path))
+            leases_watcher.addPath(leases_path);
+    };
+
+    QObject::connect(&leases_watcher, &QFileSystemWatcher::directoryChanged, &leases_watcher, on_change);
+    QObject::connect(&leases_watcher, &QFileSystemWatcher::fileChanged, &leases_watcher, on_change);
+
+    leases_watcher.addPath(data_dir);
+    if (QFile::exists(leases_path))
+        leases_watcher.addPath(leases_path);
+}
+
+void mp::DNSMasqServer::load_leases()
+{
+    // DNSMasq leases entries consist of:
+    // <lease expiration> <mac addr> <ipv4> <name> * * *
+    const std::string delimiter{" "};
+    const int hw_addr_idx{1};
+    const int ipv4_idx{2};
+
+    const QFileInfo leases_info{leases_path};
+    leases_modified = leases_info.lastModified();
+    leases_size = leases_info.exists() ? leases_info.size() : -1;
+    leases.clear();
+
+    std::ifstream leases_file{leases_path.toStdString()};
+    std::string line;
+    while (getline(leases_file, line))
+    {
+        const auto fields = mp::utils::split(line, delimiter);
+        if (fields.size() > 2)
+            leases.emplace(fields[hw_addr_idx], fields[ipv4_idx]);
+    }
+}
+
+bool mp::DNSMasqServer::load_leases_if_changed()
+{
+    const QFileInfo leases_info{leases_path};
+    const auto size = leases_info.exists() ? leases_info.size() : -1;
+    if (size == leases_size && leases_info.lastModified() == leases_modified)
+        return false;
+
+    load_leases();
+    return true;
 }
 
 void mp::DNSMasqServer::check_dnsmasq_running()
@@ -23,11 +23,16 @@
 #include <multipass/path.h>
 #include <multipass/singleton.h>
 
+#include <QDateTime>
+#include <QFileSystemWatcher>
 #include <QTemporaryFile>
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <unordered_map>
 
 namespace multipass
 {
@@ -50,6 +55,9 @@ protected:
 
 private:
     void start_dnsmasq();
+    void watch_leases();
+    void load_leases();
+    bool load_leases_if_changed();
 
     const QString data_dir;
     const QString bridge_name;
@@ -57,6 +65,15 @@ private:
     std::unique_ptr<Process> dnsmasq_cmd;
     QMetaObject::Connection finish_connection;
     QTemporaryFile conf_file;
+
+    // In-memory index of dnsmasq's leases (MAC -> IPv4), so that lookups don't need to read the leases file
+    const QString leases_path;
+    std::mutex leases_mutex;
+    std::unordered_map<std::string, std::string> leases;
+    QDateTime leases_modified;
+    qint64 leases_size = -1;
+    std::atomic_bool leases_stale{true};
+    QFileSystemWatcher leases_watcher;
 };
 
 #define MP_DNSMASQ_SERVER_FACTORY multipass::DNSMasqServerFactory::instance()
@@ -0,0 +1,299 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "link_ops.h"
+
+#include <multipass/format.h>
+
+#include <QFile>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <linux/if_link.h>
+#include <linux/if_tun.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace mp = multipass;
+
+namespace
+{
+class FdGuard
+{
+public:
+    explicit FdGuard(int fd) : fd{fd}
+    {
+    }
+
+    ~FdGuard()
+    {
+        if (fd != -1)
+            ::close(fd);
+    }
+
+    FdGuard(const FdGuard&) = delete;
+    FdGuard& operator=(const FdGuard&) = delete;
+
+    const int fd;
+};
+
+// A single rtnetlink request, built up attribute by attribute and sent with an acknowledgement requested.
+class NetlinkRequest
+{
+public:
+    NetlinkRequest(uint16_t type, uint16_t flags) : buffer(NLMSG_HDRLEN)
+    {
+        auto header = reinterpret_cast<nlmsghdr*>(buffer.data());
+        header->nlmsg_type = type;
+        header->nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK | flags;
+    }
+
+    template <typename T>
+    void add_payload(const T& payload)
+    {
+        append(&payload, sizeof(payload));
+    }
+
+    void add_attribute(uint16_t type, const void* data, size_t size)
+    {
+        const rtattr attribute{static_cast<unsigned short>(RTA_LENGTH(size)), type};
+        append(&attribute, sizeof(attribute));
+        append(data, size);
+    }
+
+    void add_attribute(uint16_t type, const std::string& value)
+    {
+        add_attribute(type, value.c_str(), value.size() + 1);
+    }
+
+    size_t begin_nested(uint16_t type)
+    {
+        const auto offset = buffer.size();
+        add_attribute(type, nullptr, 0);
+        return offset;
+    }
+
+    void end_nested(size_t offset)
+    {
+        reinterpret_cast<rtattr*>(buffer.data() + offset)->rta_len = buffer.size() - offset;
+    }
+
+    // Returns 0 on success, or the errno the kernel answered with
+    int send()
+    {
+        reinterpret_cast<nlmsghdr*>(buffer.data())->nlmsg_len = buffer.size();
+
+        FdGuard sock{::socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE)};
+        if (sock.fd == -1)
+            return errno;
+
+        sockaddr_nl kernel{};
+        kernel.nl_family = AF_NETLINK;
+        if (::sendto(sock.fd, buffer.data(), buffer.size(), 0, reinterpret_cast<sockaddr*>(&kernel), sizeof(kernel)) <
+            0)
+            return errno;
+
+        // Error acks echo the request back, so leave room for it
+        std::vector<char> reply(NLMSG_SPACE(sizeof(nlmsgerr)) + buffer.size());
+        const auto received = ::recv(sock.fd, reply.data(), reply.size(), 0);
+        if (received < 0)
+            return errno;
+
+        auto header = reinterpret_cast<const nlmsghdr*>(reply.data());
+        if (!NLMSG_OK(header, static_cast<unsigned>(received)) || header->nlmsg_type != NLMSG_ERROR)
+            return EPROTO;
+
+        return -reinterpret_cast<const nlmsgerr*>(NLMSG_DATA(header))->error;
+    }
+
+private:
+    void append(const void* data, size_t size)
+    {
+        const auto offset = buffer.size();
+        buffer.resize(offset + NLMSG_ALIGN(size));
+        if (size)
+            std::memcpy(buffer.data() + offset, data, size);
+    }
+
+    std::vector<char> buffer;
+};
+
+int index_of(const QString& name, const std::string& operation)
+{
+    const auto index = ::if_nametoindex(qUtf8Printable(name));
+    if (index == 0)
+        throw mp::LinkOpsException{errno, operation, name};
+
+    return static_cast<int>(index);
+}
+
+void send_or_throw(NetlinkRequest& request, const std::string& operation, const QString& link)
+{
+    if (const auto error = request.send(); error != 0)
+        throw mp::LinkOpsException{error, operation, link};
+}
+
+in_addr parse_ipv4(const std::string& address, const std::string& operation, const QString& link)
+{
+    in_addr parsed{};
+    if (::inet_pton(AF_INET, address.c_str(), &parsed) != 1)
+        throw mp::LinkOpsException{EINVAL, operation, link};
+
+    return parsed;
+}
+} // namespace
+
+mp::LinkOpsException::LinkOpsException(int error, const std::string& operation, const QString& link)
+    : std::system_error{error, std::system_category(), fmt::format("failed to {} {}", operation, link)},
+      operation{operation},
+      link{link}
+{
+}
+
+mp::LinkOps::LinkOps(const Singleton<LinkOps>::PrivatePass& pass) noexcept : Singleton<LinkOps>::Singleton{pass}
+{
+}
+
+bool mp::LinkOps::link_exists(const QString& name) const
+{
+    return ::if_nametoindex(qUtf8Printable(name)) != 0;
+}
+
+void mp::LinkOps::delete_link(const QString& name) const
+{
+    const std::string operation{"delete link"};
+
+    ifinfomsg info{};
+    info.ifi_family = AF_UNSPEC;
+    info.ifi_index = index_of(name, operation);
+
+    NetlinkRequest request{RTM_DELLINK, 0};
+    request.add_payload(info);
+    send_or_throw(request, operation, name);
+}
+
+void mp::LinkOps::set_link_up(const QString& name, const QString& master) const
+{
+    const std::string operation{"bring up link"};
+
+    ifinfomsg info{};
+    info.ifi_family = AF_UNSPEC;
+    info.ifi_index = index_of(name, operation);
+    info.ifi_flags = IFF_UP;
+    info.ifi_change = IFF_UP;
+
+    NetlinkRequest request{RTM_NEWLINK, 0};
+    request.add_payload(info);
+    if (!master.isEmpty())
+    {
+        const uint32_t master_index = index_of(master, operation);
+        request.add_attribute(IFLA_MASTER, &master_index, sizeof(master_index));
+    }
+
+    send_or_throw(request, operation, name);
+}
+
+void mp::LinkOps::create_bridge(const QString& name, const std::string& mac_address) const
+{
+    const std::string operation{"create bridge"};
+
+    std::array<unsigned char, 6> mac{};
+    if (std::sscanf(mac_address.c_str(), "%hhx:%hhx:%hhx:%hhx:%hhx:%hhx", &mac[0], &mac[1], &mac[2], &mac[3],
+                    &mac[4], &mac[5]) != static_cast<int>(mac.size()))
+        throw LinkOpsException{EINVAL, operation, name};
+
+    ifinfomsg info{};
+    info.ifi_family = AF_UNSPEC;
+
+    NetlinkRequest request{RTM_NEWLINK, NLM_F_CREATE | NLM_F_EXCL};
+    request.add_payload(info);
+    request.add_attribute(IFLA_IFNAME, name.toStdString());
+    request.add_attribute(IFLA_ADDRESS, mac.data(), mac.size());
+    const auto link_info = request.begin_nested(IFLA_LINKINFO);
+    request.add_attribute(IFLA_INFO_KIND, std::string{"bridge"});
+    request.end_nested(link_info);
+
+    send_or_throw(request, operation, name);
+}
+
+void mp::LinkOps::add_ipv4_address(const QString& name,
+                                   const std::string& address,
+                                   int prefix_length,
+                                   const std::string& broadcast) const
+{
+    const std::string operation{"add address to"};
+
+    const auto local = parse_ipv4(address, operation, name);
+    const auto broadcast_address = parse_ipv4(broadcast, operation, name);
+
+    ifaddrmsg info{};
+    info.ifa_family = AF_INET;
+    info.ifa_prefixlen = static_cast<unsigned char>(prefix_length);
+    info.ifa_scope = RT_SCOPE_UNIVERSE;
+    info.ifa_index = index_of(name, operation);
+
+    NetlinkRequest request{RTM_NEWADDR, NLM_F_CREATE | NLM_F_EXCL};
+    request.add_payload(info);
+    request.add_attribute(IFA_LOCAL, &local, sizeof(local));
+    request.add_attribute(IFA_ADDRESS, &local, sizeof(local));
+    request.add_attribute(IFA_BROADCAST, &broadcast_address, sizeof(broadcast_address));
+
+    send_or_throw(request, operation, name);
+}
+
+void mp::LinkOps::create_tap(const QString& name, bool multi_queue) const
+{
+    const std::string operation{"create tap device"};
+
+    FdGuard tun{::open("/dev/net/tun", O_RDWR | O_CLOEXEC)};
+    if (tun.fd == -1)
+        throw LinkOpsException{errno, operation, name};
+
+    ifreq request{};
+    std::strncpy(request.ifr_name, qUtf8Printable(name), IFNAMSIZ - 1);
+    request.ifr_flags = IFF_TAP | IFF_NO_PI;
+    if (multi_queue)
+        request.ifr_flags |= IFF_MULTI_QUEUE;
+
+    // The device would go away with the descriptor unless it is made persistent
+    if (::ioctl(tun.fd, TUNSETIFF, &request) == -1 || ::ioctl(tun.fd, TUNSETPERSIST, 1) == -1)
+        throw LinkOpsException{errno, operation, name};
+}
+
+std::optional<bool> mp::LinkOps::tap_is_multi_queue(const QString& name) const
+{
+    QFile tun_flags{QString{"/sys/class/net/%1/tun_flags"}.arg(name)};
+    if (!tun_flags.open(QFile::ReadOnly))
+        return std::nullopt;
+
+    bool ok{false};
+    const auto flags = QString{tun_flags.readAll()}.trimmed().toUInt(&ok, 0);
+    if (!ok)
+        return std::nullopt;
+
+    return (flags & IFF_MULTI_QUEUE) != 0;
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MULTIPASS_LINK_OPS_H
+#define MULTIPASS_LINK_OPS_H
+
+#include <multipass/singleton.h>
+
+#include <QString>
+
+#include <optional>
+#include <string>
+#include <system_error>
+
+#define MP_LINKOPS multipass::LinkOps::instance()
+
+namespace multipass
+{
+class LinkOpsException : public std::system_error
+{
+public:
+    LinkOpsException(int error, const std::string& operation, const QString& link);
+
+    const std::string operation;
+    const QString link;
+};
+
+// Manages network links in-process through rtnetlink and the tun driver, instead of spawning `ip`.
+// Failures throw LinkOpsException.
+class LinkOps : public Singleton<LinkOps>
+{
+public:
+    LinkOps(const Singleton<LinkOps>::PrivatePass&) noexcept;
+
+    virtual bool link_exists(const QString& name) const;
+    virtual void delete_link(const QString& name) const;
+    // Brings the link up, enslaving it to the given bridge first unless that is empty
+    virtual void set_link_up(const QString& name, const QString& master) const;
+
+    virtual void create_bridge(const QString& name, const std::string& mac_address) const;
+    virtual void add_ipv4_address(const QString& name,
+                                  const std::string& address,
+                                  int prefix_length,
+                                  const std::string& broadcast) const;
+
+    // Creates a persistent tap device that QEMU can open later
+    virtual void create_tap(const QString& name, bool multi_queue) const;
+    // Whether an existing tap device has IFF_MULTI_QUEUE, or nullopt if that cannot be told
+    virtual std::optional<bool> tap_is_multi_queue(const QString& name) const;
+};
+} // namespace multipass
+
+#endif // MULTIPASS_LINK_OPS_H
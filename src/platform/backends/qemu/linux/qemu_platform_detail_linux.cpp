@@ -16,6 +16,7 @@
  */
 
 #include "qemu_platform_detail.h"
+#include "link_ops.h"
 
 #include <multipass/file_ops.h>
 #include <multipass/format.h>
@@ -25,6 +26,9 @@
 #include <shared/linux/backend_utils.h>
 
 #include <QFile>
+#include <QFileInfo>
+
+#include <algorithm>
 
 namespace mp = multipass;
 namespace mpl = multipass::logging;
@@ -33,6 +37,14 @@ namespace
 {
 constexpr auto category = "qemu platform";
 const QString multipass_bridge_name{"mpqemubr0"};
+const QString vhost_net_device{"/dev/vhost-net"};
+constexpr auto max_tap_queues = 256; // MAX_TAP_QUEUES in the kernel
+
+// One queue pair per vCPU, so that each vCPU can send and receive without contending for a queue.
+int tap_queues_for(const mp::VirtualMachineDescription& vm_desc)
+{
+    return std::clamp(vm_desc.num_cores, 1, max_tap_queues);
+}
 
 // An interface name can only be 15 characters, so this generates a hash of the
 // VM instance name with a "tap-" prefix and then truncates it.
@@ -44,37 +56,46 @@ auto generate_tap_device_name(const std::string& vm_name)
     return QString::fromStdString(tap_name);
 }
 
-void create_tap_device(const QString& tap_name, const QString& bridge_name)
+void create_tap_device(const QString& tap_name, const QString& bridge_name, int queues)
 {
-    if (!MP_UTILS.run_cmd_for_status("ip", {"addr", "show", tap_name}))
+    // QEMU can only open a persistent tap device with the same IFF_MULTI_QUEUE setting it was created with
+    const bool multi_queue = queues > 1;
+    if (MP_LINKOPS.link_exists(tap_name))
     {
-        MP_UTILS.run_cmd_for_status("ip", {"tuntap", "add", tap_name, "mode", "tap"});
-        MP_UTILS.run_cmd_for_status("ip", {"link", "set", tap_name, "master", bridge_name});
-        MP_UTILS.run_cmd_for_status("ip", {"link", "set", tap_name, "up"});
+        const auto is_multi_queue = MP_LINKOPS.tap_is_multi_queue(tap_name);
+        if (!is_multi_queue || *is_multi_queue == multi_queue)
+            return;
+
+        mpl::log(mpl::Level::debug, category, fmt::format("Recreating {} with {} queue(s)", tap_name, queues));
+        MP_LINKOPS.delete_link(tap_name);
     }
+
+    MP_LINKOPS.create_tap(tap_name, multi_queue);
+    MP_LINKOPS.set_link_up(tap_name, bridge_name);
 }
 
-void remove_tap_device(const QString& tap_device_name)
+void delete_link_if_exists(const QString& name)
 {
-    if (MP_UTILS.run_cmd_for_status("ip", {"addr", "show", tap_device_name}))
+    if (!MP_LINKOPS.link_exists(name))
+        return;
+
+    try
+    {
+        MP_LINKOPS.delete_link(name);
+    }
+    catch (const mp::LinkOpsException& e)
     {
-        MP_UTILS.run_cmd_for_status("ip", {"link", "delete", tap_device_name});
+        mpl::log(mpl::Level::warning, category, e.what());
     }
 }
 
 void create_virtual_switch(const std::string& subnet, const QString& bridge_name)
 {
-    if (!MP_UTILS.run_cmd_for_status("ip", {"addr", "show", bridge_name}))
+    if (!MP_LINKOPS.link_exists(bridge_name))
     {
-        const auto mac_address = mp::utils::generate_mac_address();
-        const auto cidr = fmt::format("{}.1/24", subnet);
-        const auto broadcast = fmt::format("{}.255", subnet);
-
-        MP_UTILS.run_cmd_for_status("ip",
-                                    {"link", "add", bridge_name, "address", mac_address.c_str(), "type", "bridge"});
-        MP_UTILS.run_cmd_for_status(
-            "ip", {"address", "add", cidr.c_str(), "dev", bridge_name, "broadcast", broadcast.c_str()});
-        MP_UTILS.run_cmd_for_status("ip", {"link", "set", bridge_name, "up"});
+        MP_LINKOPS.create_bridge(bridge_name, mp::utils::generate_mac_address());
+        MP_LINKOPS.add_ipv4_address(bridge_name, fmt::format("{}.1", subnet), 24, fmt::format("{}.255", subnet));
+        MP_LINKOPS.set_link_up(bridge_name, QString{});
     }
 }
 
@@ -104,14 +125,6 @@ mp::DNSMasqServer::UPtr init_nat_network(const mp::Path& network_dir, const QStr
 
     return MP_DNSMASQ_SERVER_FACTORY.make_dnsmasq_server(network_dir, bridge_name, subnet);
 }
-
-void delete_virtual_switch(const QString& bridge_name)
-{
-    if (MP_UTILS.run_cmd_for_status("ip", {"addr", "show", bridge_name}))
-    {
-        MP_UTILS.run_cmd_for_status("ip", {"link", "delete", bridge_name});
-    }
-}
 } // namespace
 
 mp::QemuPlatformDetail::QemuPlatformDetail(const mp::Path& data_dir)
@@ -128,10 +141,10 @@ mp::QemuPlatformDetail::~QemuPlatformDetail()
     for (const auto& it : name_to_net_device_map)
     {
         const auto& [tap_device_name, hw_addr] = it.second;
-        remove_tap_device(tap_device_name);
+        delete_link_if_exists(tap_device_name);
     }
 
-    delete_virtual_switch(bridge_name);
+    delete_link_if_exists(bridge_name);
 }
 
 std::optional<mp::IPAddress> mp::QemuPlatformDetail::get_ip_for(const std::string& hw_addr)
@@ -146,7 +159,7 @@ void mp::QemuPlatformDetail::remove_resources_for(const std::string& name)
     {
         const auto& [tap_device_name, hw_addr] = it->second;
         dnsmasq_server->release_mac(hw_addr);
-        remove_tap_device(tap_device_name);
+        delete_link_if_exists(tap_device_name);
 
         name_to_net_device_map.erase(name);
     }
@@ -165,10 +178,24 @@ QStringList mp::QemuPlatformDetail::vm_platform_args(const VirtualMachineDescrip
 {
     // Configure and generate the args for the default network interface
     auto tap_device_name = generate_tap_device_name(vm_desc.vm_name);
-    create_tap_device(tap_device_name, bridge_name);
+    const auto queues = tap_queues_for(vm_desc);
+    create_tap_device(tap_device_name, bridge_name, queues);
 
     name_to_net_device_map.emplace(vm_desc.vm_name, std::make_pair(tap_device_name, vm_desc.default_mac_address));
 
+    auto netdev = fmt::format("tap,id=hostnet0,ifname={},script=no,downscript=no", tap_device_name);
+    auto nic = fmt::format("virtio-net-pci,netdev=hostnet0,mac={}", vm_desc.default_mac_address);
+    if (queues > 1)
+    {
+        // One vector per queue in each direction, plus one for config changes and one for the control queue
+        netdev += fmt::format(",queues={}", queues);
+        nic += fmt::format(",mq=on,vectors={}", 2 * queues + 2);
+    }
+
+    // Move packet processing out of QEMU's main loop and into the kernel when possible
+    if (MP_FILEOPS.exists(QFileInfo{vhost_net_device}))
+        netdev += ",vhost=on";
+
     QStringList opts;
 
     // Work around for Xenial where UEFI images are not one and the same
@@ -188,9 +215,7 @@ QStringList mp::QemuPlatformDetail::vm_platform_args(const VirtualMachineDescrip
          << "-cpu"
          << "host"
          // Set up the network related args
-         << "-nic"
-         << QString::fromStdString(fmt::format("tap,ifname={},script=no,downscript=no,model=virtio-net-pci,mac={}",
-                                               tap_device_name, vm_desc.default_mac_address));
+         << "-netdev" << QString::fromStdString(netdev) << "-device" << QString::fromStdString(nic);
 
     return opts;
 }
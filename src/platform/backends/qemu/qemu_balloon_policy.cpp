@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "qemu_balloon_policy.h"
+
+#include <multipass/file_ops.h>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+
+namespace mp = multipass;
+
+std::optional<double> mp::QemuBalloonPolicy::host_memory_pressure()
+{
+    // e.g. "some avg10=0.00 avg60=0.00 avg300=0.00 total=0"
+    const auto pressure = MP_FILEOPS.open_read("/proc/pressure/memory");
+    for (std::string line; pressure && std::getline(*pressure, line);)
+    {
+        std::istringstream fields{line};
+        std::string kind, avg10;
+        if (fields >> kind >> avg10 && kind == "some" && avg10.rfind("avg10=", 0) == 0)
+        {
+            try
+            {
+                return std::stod(avg10.substr(6));
+            }
+            catch (const std::logic_error&)
+            {
+                return std::nullopt;
+            }
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::optional<long long> mp::QemuBalloonPolicy::next_target(double pressure, const MemorySize& mem_size)
+{
+    auto next = percent;
+    if (pressure > high_pressure)
+        next = std::max(min_percent, percent - step_percent);
+    else if (pressure < low_pressure)
+        next = std::min(100, percent + step_percent);
+
+    if (next == percent)
+        return std::nullopt;
+
+    percent = next;
+    return mem_size.in_bytes() / 100 * percent;
+}
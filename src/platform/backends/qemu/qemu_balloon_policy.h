@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MULTIPASS_QEMU_BALLOON_POLICY_H
+#define MULTIPASS_QEMU_BALLOON_POLICY_H
+
+#include <multipass/memory_size.h>
+
+#include <optional>
+
+namespace multipass
+{
+// Shrinks a guest through its balloon while the host stalls on memory, and lets it grow back once the host recovers.
+// Free page reporting hands idle guest memory back regardless; this only adds pressure on busy guests.
+class QemuBalloonPolicy
+{
+public:
+    static constexpr double high_pressure = 10.0; // unit: % of time, shrink above this
+    static constexpr double low_pressure = 1.0;   // unit: % of time, grow back below this
+    static constexpr int min_percent = 50;
+    static constexpr int step_percent = 10;
+
+    // The "some avg10" of /proc/pressure/memory: how much of the last 10s some task spent waiting on memory. Empty if
+    // the host does not report pressure stall information.
+    static std::optional<double> host_memory_pressure();
+
+    // The balloon target, in bytes, for a guest with mem_size of RAM, if it should change
+    std::optional<long long> next_target(double pressure, const MemorySize& mem_size);
+
+private:
+    int percent{100};
+};
+} // namespace multipass
+
+#endif // MULTIPASS_QEMU_BALLOON_POLICY_H
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "qemu_guest_agent.h"
+
+#include <multipass/format.h>
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QLocalSocket>
+#include <QRandomGenerator>
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace mp = multipass;
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+constexpr char delimiter = '\xff'; // never occurs in JSON, so it resets the agent's parser and marks its sync reply
+
+QByteArray make_request(const QString& command, const QJsonObject& arguments)
+{
+    QJsonObject request{{"execute", command}};
+    if (!arguments.isEmpty())
+        request.insert("arguments", arguments);
+
+    return QJsonDocument{request}.toJson(QJsonDocument::Compact) + '\n';
+}
+
+int remaining_ms(Clock::time_point deadline)
+{
+    const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now());
+    return static_cast<int>(std::max(remaining.count(), decltype(remaining.count()){0}));
+}
+
+void send(QLocalSocket& socket, const QByteArray& request, Clock::time_point deadline)
+{
+    socket.write(request);
+    while (socket.bytesToWrite() > 0)
+        if (!socket.waitForBytesWritten(remaining_ms(deadline)))
+            throw std::runtime_error{fmt::format("failed to write to guest agent: {}", socket.errorString())};
+}
+
+void wait_for_data(QLocalSocket& socket, Clock::time_point deadline)
+{
+    if (!socket.waitForReadyRead(remaining_ms(deadline)))
+        throw std::runtime_error{"timed out waiting for guest agent"};
+}
+
+void skip_to_delimiter(QLocalSocket& socket, Clock::time_point deadline)
+{
+    char byte{};
+    do
+    {
+        while (socket.bytesAvailable() == 0)
+            wait_for_data(socket, deadline);
+        socket.getChar(&byte);
+    } while (byte != delimiter);
+}
+
+QJsonObject receive(QLocalSocket& socket, Clock::time_point deadline)
+{
+    while (!socket.canReadLine())
+        wait_for_data(socket, deadline);
+
+    const auto reply = QJsonDocument::fromJson(socket.readLine());
+    if (!reply.isObject())
+        throw std::runtime_error{"invalid reply from guest agent"};
+
+    return reply.object();
+}
+} // namespace
+
+mp::QemuGuestAgent::QemuGuestAgent(const QString& socket_path,
+                                   std::chrono::milliseconds timeout,
+                                   std::chrono::milliseconds sync_timeout)
+    : socket_path{socket_path}, timeout{timeout}, sync_timeout{sync_timeout}
+{
+}
+
+QJsonValue mp::QemuGuestAgent::execute(const QString& command, const QJsonObject& arguments) const
+{
+    const auto deadline = Clock::now() + timeout;
+
+    QLocalSocket socket;
+    socket.connectToServer(socket_path);
+    if (!socket.waitForConnected(remaining_ms(deadline)))
+        throw std::runtime_error{fmt::format("cannot connect to guest agent: {}", socket.errorString())};
+
+    // The channel outlives connections, so it may hold replies to abandoned requests, or a partial request of ours;
+    // syncing skips past them. An agent that is up answers at once, so a silent one is not waited on for long.
+    const auto sync_deadline = std::min(deadline, Clock::now() + sync_timeout);
+    const auto sync_id = QRandomGenerator::global()->bounded(1, std::numeric_limits<int>::max());
+    send(socket, delimiter + make_request("guest-sync-delimited", {{"id", sync_id}}), sync_deadline);
+    do
+    {
+        skip_to_delimiter(socket, sync_deadline);
+    } while (receive(socket, sync_deadline)["return"].toInt() != sync_id);
+
+    send(socket, make_request(command, arguments), deadline);
+    const auto reply = receive(socket, deadline);
+    if (reply.contains("error"))
+        throw std::runtime_error{fmt::format("guest agent failed to execute {}: {}",
+                                             command,
+                                             reply["error"].toObject()["desc"].toString())};
+
+    return reply["return"];
+}
+
+std::vector<std::string> mp::QemuGuestAgent::get_all_ipv4() const
+{
+    std::vector<std::string> all_ipv4;
+    for (const auto& interface : execute("guest-network-get-interfaces").toArray())
+    {
+        const auto interface_object = interface.toObject();
+        if (interface_object["name"].toString() == "lo")
+            continue;
+
+        for (const auto& address : interface_object["ip-addresses"].toArray())
+        {
+            const auto address_object = address.toObject();
+            const auto ip = address_object["ip-address"].toString();
+
+            // match what "scope global" gets us over SSH
+            if (address_object["ip-address-type"].toString() == "ipv4" && !ip.startsWith("169.254.") &&
+                !ip.startsWith("127."))
+                all_ipv4.push_back(ip.toStdString());
+        }
+    }
+
+    return all_ipv4;
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MULTIPASS_QEMU_GUEST_AGENT_H
+#define MULTIPASS_QEMU_GUEST_AGENT_H
+
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QString>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace multipass
+{
+// Client for the QEMU guest agent, which QEMU exposes through a virtio-serial port bound to a UNIX socket on the host.
+// It does not need guest networking or SSH. Each call uses a connection of its own, so it can be used from any thread,
+// without an event loop. The socket accepts connections whether or not the agent runs in the guest, so calls give up
+// after sync_timeout if nothing answers the initial sync.
+class QemuGuestAgent
+{
+public:
+    explicit QemuGuestAgent(const QString& socket_path,
+                            std::chrono::milliseconds timeout = std::chrono::seconds{2},
+                            std::chrono::milliseconds sync_timeout = std::chrono::milliseconds{250});
+
+    // Throws std::runtime_error if the agent can't be reached, does not respond in time, or reports an error
+    QJsonValue execute(const QString& command, const QJsonObject& arguments = {}) const;
+
+    std::vector<std::string> get_all_ipv4() const;
+
+private:
+    const QString socket_path;
+    const std::chrono::milliseconds timeout;
+    const std::chrono::milliseconds sync_timeout;
+};
+} // namespace multipass
+
+#endif // MULTIPASS_QEMU_GUEST_AGENT_H
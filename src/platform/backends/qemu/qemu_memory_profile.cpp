@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "qemu_memory_profile.h"
+
+#include <multipass/constants.h>
+#include <multipass/file_ops.h>
+#include <multipass/format.h>
+
+#include <QDir>
+
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+
+#ifdef MULTIPASS_PLATFORM_LINUX
+#include <sched.h>
+#endif
+
+namespace mp = multipass;
+
+namespace
+{
+const auto node_option = QStringLiteral("node=");
+constexpr auto hugepages_backing = "hugepages";
+
+std::string node_dir(int node)
+{
+    return fmt::format("/sys/devices/system/node/node{}", node);
+}
+
+std::string read_first_line(const mp::fs::path& path)
+{
+    std::string line;
+    const auto stream = MP_FILEOPS.open_read(path);
+    if (!stream || !std::getline(*stream, line))
+        throw std::runtime_error{fmt::format("Could not read {}", path.string())};
+
+    return line;
+}
+
+long long default_hugepage_kib()
+{
+    const auto meminfo = MP_FILEOPS.open_read("/proc/meminfo");
+    for (std::string line; meminfo && std::getline(*meminfo, line);)
+    {
+        std::istringstream fields{line};
+        std::string name;
+        long long kib = 0;
+        if (fields >> name >> kib && name == "Hugepagesize:")
+            return kib;
+    }
+
+    throw std::runtime_error{"Could not find the host's hugepage size"};
+}
+} // namespace
+
+QStringList mp::QemuMemoryProfile::backings()
+{
+#ifdef MULTIPASS_PLATFORM_LINUX
+    return {mp::default_memory_profile, "prealloc", hugepages_backing};
+#else
+    return {mp::default_memory_profile};
+#endif
+}
+
+mp::QemuMemoryProfile mp::QemuMemoryProfile::parse(const std::string& profile)
+{
+    const auto options = QString::fromStdString(profile).split(',');
+    if (!backings().contains(options.front()) || options.size() > 2)
+        throw std::invalid_argument{
+            fmt::format("Unknown memory profile, valid options are: {}{}",
+                        backings().join(", "),
+                        backings().size() > 1 ? ", optionally followed by \",node=<host NUMA node>\"" : "")};
+
+    QemuMemoryProfile ret{options.front().toStdString(), std::nullopt};
+    if (options.size() == 2)
+    {
+        const auto& option = options.back();
+        auto ok = false;
+        const auto node = option.startsWith(node_option) ? option.mid(node_option.size()).toInt(&ok) : -1;
+        if (!ok || node < 0 || backings().size() == 1)
+            throw std::invalid_argument{fmt::format("Invalid memory profile option: {}", option)};
+
+        std::error_code err;
+        if (!MP_FILEOPS.exists(mp::fs::path{node_dir(node)}, err))
+            throw std::invalid_argument{fmt::format("Host NUMA node {} not found", node)};
+
+        ret.host_node = node;
+    }
+
+    return ret;
+}
+
+bool mp::QemuMemoryProfile::uses_hugepages() const
+{
+    return backing == hugepages_backing;
+}
+
+QStringList mp::QemuMemoryProfile::backend_arguments(const MemorySize& mem_size, bool shared) const
+{
+    if (backing == mp::default_memory_profile && !host_node && !shared)
+        return {};
+
+    auto backend = QString{"memory-backend-memfd,id=mem,size=%1M"}.arg(mem_size.in_megabytes());
+    if (shared)
+        backend += ",share=on";
+    if (uses_hugepages())
+        backend += ",hugetlb=on";
+    // hugepages are preallocated too, so that running short of them fails the start rather than the guest later on
+    if (backing != mp::default_memory_profile)
+        backend += ",prealloc=on";
+    if (host_node)
+        backend += QString{",host-nodes=%1,policy=bind"}.arg(*host_node);
+
+    return {"-object", backend, "-numa", "node,memdev=mem"};
+}
+
+void mp::QemuMemoryProfile::check_hugepages_available(const MemorySize& mem_size) const
+{
+    if (!uses_hugepages())
+        return;
+
+    const auto page_kib = default_hugepage_kib();
+    const auto pool = host_node ? fmt::format("{}/hugepages/hugepages-{}kB", node_dir(*host_node), page_kib)
+                                : fmt::format("/sys/kernel/mm/hugepages/hugepages-{}kB", page_kib);
+    const auto available = std::stoll(read_first_line(pool + "/free_hugepages"));
+    const auto needed = (mem_size.in_kilobytes() + page_kib - 1) / page_kib;
+
+    if (available < needed)
+        throw std::runtime_error{fmt::format("Not enough free hugepages{}: {} of {} KiB needed, {} available",
+                                             host_node ? fmt::format(" on host NUMA node {}", *host_node) : "",
+                                             needed,
+                                             page_kib,
+                                             available)};
+}
+
+void mp::QemuMemoryProfile::pin_to_host_node(qint64 pid) const
+{
+    if (!host_node)
+        return;
+
+#ifdef MULTIPASS_PLATFORM_LINUX
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+
+    // e.g. "0-7,16-23"
+    const auto cpu_list = QString::fromStdString(read_first_line(node_dir(*host_node) + "/cpulist"));
+    for (const auto& range : cpu_list.split(',', Qt::SkipEmptyParts))
+    {
+        const auto bounds = range.split('-');
+        for (auto cpu = bounds.front().toInt(); cpu <= bounds.back().toInt(); ++cpu)
+            CPU_SET(cpu, &cpus);
+    }
+
+    for (const auto& task : QDir{QString{"/proc/%1/task"}.arg(pid)}.entryList(QDir::Dirs | QDir::NoDotAndDotDot))
+        if (sched_setaffinity(task.toInt(), sizeof(cpus), &cpus) != 0)
+            throw std::system_error{errno,
+                                    std::generic_category(),
+                                    fmt::format("failed to pin thread {} to host NUMA node {}", task, *host_node)};
+#endif
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MULTIPASS_QEMU_MEMORY_PROFILE_H
+#define MULTIPASS_QEMU_MEMORY_PROFILE_H
+
+#include <multipass/memory_size.h>
+
+#include <QStringList>
+
+#include <optional>
+#include <string>
+
+namespace multipass
+{
+// How guest RAM is backed on the host, from the `local.<instance>.memory-profile` setting. The setting takes a backing,
+// optionally followed by the host NUMA node to bind to, e.g. "hugepages,node=1".
+struct QemuMemoryProfile
+{
+    std::string backing;          // one of backings()
+    std::optional<int> host_node; // memory is bound and QEMU's threads pinned to this node
+
+    static QStringList backings();
+    static QemuMemoryProfile parse(const std::string& profile); // throws std::invalid_argument if unknown
+
+    bool uses_hugepages() const;
+
+    // Arguments backing guest RAM with a memfd; shared memory is needed by vhost-user devices. Empty if the default
+    // anonymous memory will do.
+    QStringList backend_arguments(const MemorySize& mem_size, bool shared) const;
+
+    // Throws std::runtime_error if the host lacks free hugepages to back mem_size
+    void check_hugepages_available(const MemorySize& mem_size) const;
+
+    // Restrict the threads of a running process to the CPUs of host_node, if set. Later threads inherit this.
+    void pin_to_host_node(qint64 pid) const;
+};
+} // namespace multipass
+
+#endif // MULTIPASS_QEMU_MEMORY_PROFILE_H
@@ -28,6 +28,29 @@ namespace mpu = multipass::utils;
 namespace
 {
 constexpr auto category = "qemu-mount-handler";
+
+// host id => instance id, with the default user standing in for unspecified ids
+std::pair<int, int> native_mount_id_map(const mp::id_mappings& mappings)
+{
+    if (mappings.empty())
+        return {1000, 1000};
+
+    const auto& [host_id, instance_id] = mappings.front();
+    return {host_id, instance_id == -1 ? 1000 : instance_id};
+}
+
+// UNIX socket paths are limited to 104 bytes on some platforms (108 on Linux), including the terminating null
+QString virtiofs_socket_path(const mp::VirtualMachine& vm, const std::string& tag)
+{
+    constexpr auto max_socket_path_size = 103;
+    const auto path = vm.instance_directory().absoluteFilePath(
+        QString{"vfs-%1.sock"}.arg(QString::fromStdString(tag).left(8)));
+
+    if (path.toLocal8Bit().size() > max_socket_path_size)
+        throw std::runtime_error(fmt::format("The virtiofs socket path '{}' is too long", path));
+
+    return path;
+}
 } // namespace
 
 namespace multipass
@@ -38,15 +61,26 @@ QemuMountHandler::QemuMountHandler(QemuVirtualMachine* vm,
                                    VMMount mount_spec)
     : MountHandler{vm, ssh_key_provider, std::move(mount_spec), target},
       vm_mount_args{vm->modifiable_mount_args()},
+      vm_virtiofs_shares{vm->modifiable_virtiofs_shares()},
       // Create a reproducible unique mount tag for each mount. The cmd arg can only be 31 bytes long so part of the
       // uuid must be truncated. First character of tag must also be alphabetical.
-      tag{mp::utils::make_uuid(target).remove("-").left(30).prepend('m').toStdString()}
+      tag{mp::utils::make_uuid(target).remove("-").left(30).prepend('m').toStdString()},
+      virtiofs{vm->uses_virtiofs_mounts()}
 {
     auto state = vm->current_state();
-    if (state == VirtualMachine::State::suspended && vm_mount_args.find(tag) != vm_mount_args.end())
+    if (const auto it = vm_mount_args.find(tag);
+        state == VirtualMachine::State::suspended && it != vm_mount_args.end())
     {
         mpl::log(mpl::Level::info, category,
                  fmt::format("Found native mount {} => {} in '{}' while suspended", source, target, vm->vm_name));
+
+        // keep the mount type the instance was suspended with, whatever the current setting
+        virtiofs = is_virtiofs_mount(it->second.second);
+        if (virtiofs)
+            vm_virtiofs_shares[tag] = {source,
+                                       virtiofs_socket_path(*vm, tag),
+                                       native_mount_id_map(this->mount_spec.get_uid_mappings()),
+                                       native_mount_id_map(this->mount_spec.get_gid_mappings())};
         return;
     }
 
@@ -62,12 +96,25 @@ QemuMountHandler::QemuMountHandler(QemuVirtualMachine* vm,
     mpl::log(mpl::Level::info, category,
              fmt::format("initializing native mount {} => {} in '{}'", source, target, vm->vm_name));
 
-    const auto uid_map = this->mount_spec.get_uid_mappings().empty() ? std::make_pair(1000, 1000)
-                                                                     : this->mount_spec.get_uid_mappings()[0];
-    const auto gid_map = this->mount_spec.get_gid_mappings().empty() ? std::make_pair(1000, 1000)
-                                                                     : this->mount_spec.get_gid_mappings()[0];
-    const auto uid_arg = QString("uid_map=%1:%2,").arg(uid_map.first).arg(uid_map.second == -1 ? 1000 : uid_map.second);
-    const auto gid_arg = QString{"gid_map=%1:%2,"}.arg(gid_map.first).arg(gid_map.second == -1 ? 1000 : gid_map.second);
+    const auto uid_map = native_mount_id_map(this->mount_spec.get_uid_mappings());
+    const auto gid_map = native_mount_id_map(this->mount_spec.get_gid_mappings());
+
+    if (virtiofs)
+    {
+        // QEMU only relays the vhost-user protocol, the files are served by a virtiofsd process that the VM runs
+        const auto socket_path = virtiofs_socket_path(*vm, tag);
+        const auto id = QString::fromStdString(tag);
+        vm_virtiofs_shares[tag] = {source, socket_path, uid_map, gid_map};
+        vm_mount_args[tag] = {source,
+                              {"-chardev",
+                               QString{"socket,id=%1,path=%2"}.arg(id, socket_path),
+                               "-device",
+                               QString{"vhost-user-fs-pci,id=%1,chardev=%1,tag=%1"}.arg(id)}};
+        return;
+    }
+
+    const auto uid_arg = QString("uid_map=%1:%2,").arg(uid_map.first).arg(uid_map.second);
+    const auto gid_arg = QString{"gid_map=%1:%2,"}.arg(gid_map.first).arg(gid_map.second);
     vm_mount_args[tag] = {
         source,
         {"-virtfs", QString::fromStdString(fmt::format("local,security_model=passthrough,{}{}path={},mount_tag={}",
@@ -77,14 +124,15 @@ QemuMountHandler::QemuMountHandler(QemuVirtualMachine* vm,
 bool QemuMountHandler::is_active()
 try
 {
+    const auto type = virtiofs ? "virtiofs" : "9p";
     return active && !SSHSession{vm->ssh_hostname(), vm->ssh_port(), vm->ssh_username(), *ssh_key_provider}
-                          .exec(fmt::format("findmnt --type 9p | grep '{} {}'", target, tag))
+                          .exec(fmt::format("findmnt --type {} | grep '{} {}'", type, target, tag))
                           .exit_code();
 }
 catch (const std::exception& e)
 {
     mpl::log(mpl::Level::warning, category,
-             fmt::format("Failed checking 9p mount \"{}\" in instance '{}': {}", target, vm->vm_name, e.what()));
+             fmt::format("Failed checking native mount \"{}\" in instance '{}': {}", target, vm->vm_name, e.what()));
     return false;
 }
 
@@ -109,7 +157,8 @@ void QemuMountHandler::activate_impl(ServerVariant, std::chrono::milliseconds)
 
     MP_UTILS.run_in_ssh_session(
         session,
-        fmt::format("sudo mount -t 9p {} {} -o trans=virtio,version=9p2000.L,msize=536870912", tag, target));
+        virtiofs ? fmt::format("sudo mount -t virtiofs {} {}", tag, target)
+                 : fmt::format("sudo mount -t 9p {} {} -o trans=virtio,version=9p2000.L,msize=536870912", tag, target));
 }
 
 void QemuMountHandler::deactivate_impl(bool force)
@@ -133,5 +182,6 @@ QemuMountHandler::~QemuMountHandler()
 {
     deactivate(/*force=*/true);
     vm_mount_args.erase(tag);
+    vm_virtiofs_shares.erase(tag);
 }
 } // namespace multipass
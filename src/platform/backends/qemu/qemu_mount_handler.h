@@ -39,7 +39,9 @@ public:
 
 private:
     QemuVirtualMachine::MountArgs& vm_mount_args;
+    QemuVirtualMachine::VirtiofsShares& vm_virtiofs_shares;
     std::string tag;
+    bool virtiofs;
 };
 
 } // namespace multipass
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "qemu_qmp_client.h"
+
+#include <multipass/format.h>
+#include <multipass/logging/log.h>
+
+#include <QJsonDocument>
+
+#include <optional>
+#include <stdexcept>
+
+namespace mp = multipass;
+namespace mpl = multipass::logging;
+
+namespace
+{
+constexpr auto category = "qmp";
+
+std::optional<QJsonObject> parse_message(const QByteArray& data)
+{
+    QJsonParseError error;
+    const auto document = QJsonDocument::fromJson(data, &error);
+    if (error.error != QJsonParseError::NoError || !document.isObject())
+        return std::nullopt;
+
+    return document.object();
+}
+} // namespace
+
+mp::QmpClient::QmpClient(Writer writer, EventHandler event_handler)
+    : writer{std::move(writer)}, event_handler{std::move(event_handler)}
+{
+}
+
+std::future<QJsonValue> mp::QmpClient::execute(const QString& command, const QJsonObject& arguments)
+{
+    QJsonObject request{{"execute", command}};
+    if (!arguments.isEmpty())
+        request.insert("arguments", arguments);
+
+    std::future<QJsonValue> reply;
+    {
+        // registered before writing, as the reply can come in before write() returns
+        std::lock_guard lock{pending_mutex};
+        const auto id = next_id++;
+        request.insert("id", id);
+        reply = pending[id].reply.get_future();
+        pending[id].command = command;
+    }
+
+    writer(QJsonDocument{request}.toJson(QJsonDocument::Compact) + '\n');
+    return reply;
+}
+
+void mp::QmpClient::handle_output(const QByteArray& output)
+{
+    partial_output.append(output);
+
+    auto lines = partial_output.split('\n');
+    partial_output = lines.takeLast();
+
+    // QEMU terminates every message with a line break, but one may also end up complete without it
+    if (parse_message(partial_output))
+    {
+        lines.append(partial_output);
+        partial_output.clear();
+    }
+
+    for (const auto& line : lines)
+    {
+        if (line.trimmed().isEmpty())
+            continue;
+
+        if (auto message = parse_message(line))
+            handle_message(*message);
+        else
+            mpl::log(mpl::Level::warning, category, fmt::format("Ignoring malformed QMP output: {}", line));
+    }
+}
+
+void mp::QmpClient::abandon_pending(const std::string& reason)
+{
+    std::unordered_map<qint64, PendingCommand> abandoned;
+    {
+        std::lock_guard lock{pending_mutex};
+        abandoned.swap(pending);
+    }
+
+    for (auto& [_, pending_command] : abandoned)
+        pending_command.reply.set_exception(std::make_exception_ptr(std::runtime_error{
+            fmt::format("QMP command {} abandoned: {}", pending_command.command, reason)}));
+}
+
+void mp::QmpClient::handle_message(const QJsonObject& message)
+{
+    if (message.contains("event"))
+    {
+        event_handler(message["event"].toString(), message["data"].toObject());
+        return;
+    }
+
+    if (!message.contains("return") && !message.contains("error"))
+        return; // the greeting
+
+    std::optional<PendingCommand> pending_command;
+    {
+        std::lock_guard lock{pending_mutex};
+        if (auto it = pending.find(message["id"].toInteger(-1)); it != pending.end())
+        {
+            pending_command = std::move(it->second);
+            pending.erase(it);
+        }
+    }
+
+    if (!pending_command)
+        return; // not ours, e.g. sent before this client took over
+
+    if (message.contains("error"))
+    {
+        const auto error = message["error"].toObject();
+        const auto failure = fmt::format("QMP command {} failed: {} ({})",
+                                         pending_command->command,
+                                         error["desc"].toString(),
+                                         error["class"].toString());
+
+        mpl::log(mpl::Level::warning, category, failure);
+        pending_command->reply.set_exception(std::make_exception_ptr(std::runtime_error{failure}));
+    }
+    else
+        pending_command->reply.set_value(message["return"]);
+}
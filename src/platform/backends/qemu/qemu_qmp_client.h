@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MULTIPASS_QEMU_QMP_CLIENT_H
+#define MULTIPASS_QEMU_QMP_CLIENT_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QString>
+
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace multipass
+{
+// Client for the QEMU Machine Protocol, over whatever channel the monitor is attached to. Each command carries an id
+// that QEMU echoes in its reply, so commands can be issued back to back, from any thread, and their replies collected
+// later. Whatever QEMU writes is fed to handle_output(); events are handed to the event handler in the order they
+// arrive. Futures must not be waited on from the thread feeding the output, as their replies would never be read.
+class QmpClient
+{
+public:
+    using Writer = std::function<void(const QByteArray&)>;
+    using EventHandler = std::function<void(const QString& event, const QJsonObject& data)>;
+
+    QmpClient(Writer writer, EventHandler event_handler);
+
+    // The future holds the "return" value of the command, or a std::runtime_error if QEMU reports an error or the
+    // command is abandoned. Errors are logged too, so callers can ignore the future.
+    std::future<QJsonValue> execute(const QString& command, const QJsonObject& arguments = {});
+
+    // Replies and events may arrive split across calls or several in one
+    void handle_output(const QByteArray& output);
+
+    // Fail the commands still waiting for a reply, e.g. because QEMU is gone
+    void abandon_pending(const std::string& reason);
+
+private:
+    struct PendingCommand
+    {
+        QString command;
+        std::promise<QJsonValue> reply;
+    };
+
+    void handle_message(const QJsonObject& message);
+
+    const Writer writer;
+    const EventHandler event_handler;
+    std::mutex pending_mutex;
+    qint64 next_id{0};
+    std::unordered_map<qint64, PendingCommand> pending;
+    QByteArray partial_output;
+};
+} // namespace multipass
+
+#endif // MULTIPASS_QEMU_QMP_CLIENT_H
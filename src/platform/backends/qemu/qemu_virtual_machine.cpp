@@ -16,7 +16,10 @@
  */
 
 #include "qemu_virtual_machine.h"
+#include "qemu_guest_agent.h"
+#include "qemu_memory_profile.h"
 #include "qemu_mount_handler.h"
+#include "qemu_qmp_client.h"
 #include "qemu_snapshot.h"
 #include "qemu_vm_process_spec.h"
 #include "qemu_vmstate_process_spec.h"
@@ -42,6 +45,7 @@
 #include <QTemporaryFile>
 
 #include <cassert>
+#include <thread>
 
 namespace mp = multipass;
 namespace mpl = multipass::logging;
@@ -57,8 +61,14 @@ constexpr auto mount_data_key = "mount_data";
 constexpr auto mount_source_key = "source";
 constexpr auto mount_arguments_key = "arguments";
 
+constexpr auto guest_agent_retry_interval = 1min;
+constexpr auto partial_state_suffix = ".part";
+constexpr qint64 unthrottled_migration_bandwidth = 100LL << 30; // unit: bytes/s, QEMU's default is meant for live runs
 constexpr int shutdown_timeout = 300000;   // unit: ms, 5 minute timeout for shutdown/suspend
 constexpr int kill_process_timeout = 5000; // unit: ms, 5 seconds timeout for killing the process
+constexpr auto virtiofsd_socket_timeout = 5s;
+constexpr auto virtiofs_unplug_timeout = 30s; // the guest has to release the devices before QEMU drops them
+constexpr auto balloon_interval = 5s;
 
 bool use_cdrom_set(const QJsonObject& metadata)
 {
@@ -106,8 +116,23 @@ auto mount_args_from_json(const QJsonObject& object)
     return mount_args;
 }
 
+// UNIX socket paths are limited to 104 bytes on some platforms (108 on Linux), including the terminating null
+QString guest_agent_socket_path(const QDir& instance_dir)
+{
+    constexpr auto max_socket_path_size = 103;
+    const auto path = instance_dir.absoluteFilePath("qga.sock");
+
+    return path.toLocal8Bit().size() <= max_socket_path_size ? path : QString{};
+}
+
+QString suspend_state_path_for(const QDir& instance_dir)
+{
+    return instance_dir.absoluteFilePath("suspend.vmstate");
+}
+
 auto make_qemu_process(const mp::VirtualMachineDescription& desc, const std::optional<QJsonObject>& resume_metadata,
-                       const mp::QemuVirtualMachine::MountArgs& mount_args, const QStringList& platform_args)
+                       const mp::QemuVirtualMachine::MountArgs& mount_args, const QStringList& platform_args,
+                       const QString& guest_agent_socket, const QString& suspend_state_file, bool from_state_file)
 {
     if (!QFile::exists(desc.image.image_path) || !QFile::exists(desc.cloud_init_iso))
     {
@@ -119,10 +144,11 @@ auto make_qemu_process(const mp::VirtualMachineDescription& desc, const std::opt
     {
         const auto& data = resume_metadata.value();
         resume_data = mp::QemuVMProcessSpec::ResumeData{suspend_tag, get_vm_machine(data), use_cdrom_set(data),
-                                                        get_arguments(data)};
+                                                        get_arguments(data), from_state_file};
     }
 
-    auto process_spec = std::make_unique<mp::QemuVMProcessSpec>(desc, platform_args, mount_args, resume_data);
+    auto process_spec = std::make_unique<mp::QemuVMProcessSpec>(desc, platform_args, mount_args, resume_data,
+                                                                guest_agent_socket, suspend_state_file);
     auto process = mp::platform::make_process(std::move(process_spec));
 
     mpl::log(mpl::Level::debug, desc.vm_name, fmt::format("process working dir '{}'", process->working_directory()));
@@ -131,23 +157,39 @@ auto make_qemu_process(const mp::VirtualMachineDescription& desc, const std::opt
     return process;
 }
 
-auto qmp_execute_json(const QString& cmd)
+// Write the guest's memory out to a file of its own, rather than into the image. The vCPUs are stopped first, so this
+// is a single pass over RAM, and the bandwidth limit meant for live migration is lifted. QEMU writes the file itself,
+// so "completed" is only reported once all of it is there, which a helper process at the end of a pipe can't promise.
+void write_migrate_to_file(mp::QmpClient& qmp, const QString& state_file)
 {
-    QJsonObject qmp;
-    qmp.insert("execute", cmd);
-    return QJsonDocument(qmp).toJson();
+    const auto capabilities = QJsonArray{QJsonObject{{"capability", "events"}, {"state", true}}};
+    qmp.execute("migrate-set-capabilities", {{"capabilities", capabilities}});
+    qmp.execute("migrate-set-parameters", {{"max-bandwidth", unthrottled_migration_bandwidth}});
+    qmp.execute("stop");
+
+    qmp.execute("migrate", {{"uri", "file:" + state_file + partial_state_suffix}});
 }
 
-auto hmc_to_qmp_json(const QString& command_line)
+// Read the guest's memory back in. QEMU was started with "-incoming defer", so that migration events can be enabled
+// before the migration begins; the incoming side otherwise reports nothing and the vCPUs would be left stopped.
+void read_migrate_from_file(mp::QmpClient& qmp, const QString& state_file)
 {
-    auto qmp = QJsonDocument::fromJson(qmp_execute_json("human-monitor-command")).object();
+    const auto capabilities = QJsonArray{QJsonObject{{"capability", "events"}, {"state", true}}};
+    qmp.execute("migrate-set-capabilities", {{"capabilities", capabilities}});
 
-    QJsonObject cmd_line;
-    cmd_line.insert("command-line", command_line);
+    qmp.execute("migrate-incoming", {{"uri", "file:" + state_file}});
+}
 
-    qmp.insert("arguments", cmd_line);
+bool remove_suspend_state_file(const QString& state_file)
+{
+    auto removed = QFile::remove(state_file);
+    removed = QFile::remove(state_file + partial_state_suffix) || removed;
+    return removed;
+}
 
-    return QJsonDocument(qmp).toJson();
+auto execute_hmc(mp::QmpClient& qmp, const QString& command_line)
+{
+    return qmp.execute("human-monitor-command", {{"command-line", command_line}});
 }
 
 auto get_qemu_machine_type(const QStringList& platform_args)
@@ -215,9 +257,14 @@ mp::QemuVirtualMachine::QemuVirtualMachine(const VirtualMachineDescription& desc
                                            QemuPlatform* qemu_platform,
                                            VMStatusMonitor& monitor,
                                            const SSHKeyProvider& key_provider,
-                                           const Path& instance_dir)
-    : BaseVirtualMachine{mp::backend::instance_image_has_snapshot(desc.image.image_path, suspend_tag) ? State::suspended
-                                                                                                      : State::off,
+                                           const Path& instance_dir,
+                                           bool suspend_to_file,
+                                           bool virtiofs_mounts,
+                                           bool balloon_on_pressure)
+    : BaseVirtualMachine{QFile::exists(suspend_state_path_for(instance_dir)) ||
+                                 mp::backend::instance_image_has_snapshot(desc.image.image_path, suspend_tag)
+                             ? State::suspended
+                             : State::off,
                          desc.vm_name,
                          key_provider,
                          instance_dir},
@@ -226,7 +273,12 @@ mp::QemuVirtualMachine::QemuVirtualMachine(const VirtualMachineDescription& desc
       username{desc.ssh_username},
       qemu_platform{qemu_platform},
       monitor{&monitor},
-      mount_args{mount_args_from_json(monitor.retrieve_metadata_for(vm_name))}
+      mount_args{mount_args_from_json(monitor.retrieve_metadata_for(vm_name))},
+      guest_agent_socket{guest_agent_socket_path(instance_dir)},
+      suspend_state_file{suspend_state_path_for(instance_dir)},
+      suspend_to_file{suspend_to_file},
+      virtiofs_mounts{virtiofs_mounts},
+      balloon_on_pressure{balloon_on_pressure}
 {
     convert_to_qcow2_v3_if_necessary(desc.image.image_path,
                                      vm_name); // TODO drop in a couple of releases (went in on v1.13)
@@ -235,7 +287,13 @@ mp::QemuVirtualMachine::QemuVirtualMachine(const VirtualMachineDescription& desc
         this, &QemuVirtualMachine::on_delete_memory_snapshot, this,
         [this] {
             mpl::log(mpl::Level::debug, vm_name, fmt::format("Deleted memory snapshot"));
-            vm_process->write(hmc_to_qmp_json(QString("delvm ") + suspend_tag));
+            if (resuming_from_state_file)
+            {
+                QFile::remove(suspend_state_file);
+                resuming_from_state_file = false;
+            }
+            else
+                execute_hmc(*qmp, QString("delvm ") + suspend_tag);
             is_starting_from_suspend = false;
         },
         Qt::QueuedConnection);
@@ -247,18 +305,8 @@ mp::QemuVirtualMachine::QemuVirtualMachine(const VirtualMachineDescription& desc
         [this] {
             mpl::log(mpl::Level::debug, vm_name, fmt::format("Resetting the network"));
 
-            auto qmp = QJsonDocument::fromJson(qmp_execute_json("set_link")).object();
-            QJsonObject args;
-            args.insert("name", "virtio-net-pci.0");
-            args.insert("up", false);
-            qmp.insert("arguments", args);
-
-            vm_process->write(QJsonDocument(qmp).toJson());
-
-            args["up"] = true;
-            qmp["arguments"] = args;
-
-            vm_process->write(QJsonDocument(qmp).toJson());
+            qmp->execute("set_link", {{"name", "virtio-net-pci.0"}, {"up", false}});
+            qmp->execute("set_link", {{"name", "virtio-net-pci.0"}, {"up", true}});
         },
         Qt::QueuedConnection);
 
@@ -278,6 +326,9 @@ mp::QemuVirtualMachine::QemuVirtualMachine(const VirtualMachineDescription& desc
             }
         },
         Qt::QueuedConnection);
+
+    // instances may be constructed off the daemon thread, so the timer is only started along with the VM
+    QObject::connect(&balloon_timer, &QTimer::timeout, this, &QemuVirtualMachine::adjust_balloon);
 }
 
 mp::QemuVirtualMachine::~QemuVirtualMachine()
@@ -288,7 +339,17 @@ mp::QemuVirtualMachine::~QemuVirtualMachine()
 
         if (state == State::running)
         {
-            suspend();
+            try
+            {
+                suspend();
+            }
+            catch (const std::exception& e)
+            {
+                mpl::log(mpl::Level::warning,
+                         vm_name,
+                         fmt::format("Shutting down instead of suspending: {}", e.what()));
+                shutdown();
+            }
         }
         else
         {
@@ -321,8 +382,16 @@ void mp::QemuVirtualMachine::start()
                                      generate_metadata(qemu_platform->vmstate_platform_args(), proc_args, mount_args));
     }
 
+    const auto memory_profile = QemuMemoryProfile::parse(desc.memory_profile);
+    memory_profile.check_hugepages_available(desc.mem_size);
+    balloon_policy = QemuBalloonPolicy{}; // a new QEMU process starts with the balloon deflated
+
+    start_virtiofsd();
     vm_process->start();
 
+    if (balloon_on_pressure && !balloon_timer.isActive())
+        balloon_timer.start(balloon_interval);
+
     if (!vm_process->wait_for_started())
     {
         auto process_state = vm_process->process_state();
@@ -342,7 +411,22 @@ void mp::QemuVirtualMachine::start()
         }
     }
 
-    vm_process->write(qmp_execute_json("qmp_capabilities"));
+    try
+    {
+        memory_profile.pin_to_host_node(vm_process->process_id());
+    }
+    catch (const std::exception& e)
+    {
+        mpl::log(mpl::Level::warning, vm_name, fmt::format("Failed to pin to the host NUMA node: {}", e.what()));
+    }
+
+    qmp->execute("qmp_capabilities");
+
+    if (resuming_from_state_file)
+    {
+        migrating_from_state_file = true;
+        read_migrate_from_file(*qmp, suspend_state_file);
+    }
 }
 
 void mp::QemuVirtualMachine::shutdown(bool force)
@@ -380,7 +464,12 @@ void mp::QemuVirtualMachine::shutdown(bool force)
             mpl::log(mpl::Level::debug, vm_name, "No process to kill");
         }
 
-        if (state == State::suspended || mp::backend::instance_image_has_snapshot(desc.image.image_path, suspend_tag))
+        if (remove_suspend_state_file(suspend_state_file))
+        {
+            mpl::log(mpl::Level::info, vm_name, "Deleted suspend state file");
+        }
+        else if (state == State::suspended ||
+                 mp::backend::instance_image_has_snapshot(desc.image.image_path, suspend_tag))
         {
             mpl::log(mpl::Level::info, vm_name, "Deleting suspend image");
             mp::backend::delete_instance_suspend_image(desc.image.image_path, suspend_tag);
@@ -396,7 +485,7 @@ void mp::QemuVirtualMachine::shutdown(bool force)
 
         if (vm_process && vm_process->running())
         {
-            vm_process->write(qmp_execute_json("system_powerdown"));
+            qmp->execute("system_powerdown");
             vm_process->wait_for_finished(shutdown_timeout);
         }
     }
@@ -406,6 +495,10 @@ void mp::QemuVirtualMachine::suspend()
 {
     if ((state == State::running || state == State::delayed_shutdown) && vm_process->running())
     {
+        // refuses to suspend, leaving everything in place, if the guest cannot let go of its virtiofs shares
+        const auto virtiofs_mounts = unmount_virtiofs_shares();
+
+        const auto previous_update_shutdown_status = update_shutdown_status;
         if (update_shutdown_status)
         {
             state = State::suspending;
@@ -413,8 +506,22 @@ void mp::QemuVirtualMachine::suspend()
             update_shutdown_status = false;
         }
 
+        // the state can only be written once QEMU confirms the virtiofs devices are gone
+        if (!unplug_virtiofs_shares() || wait_for_virtiofs_unplugs())
+            write_suspend_commands();
+        else
+        {
+            restore_virtiofs_shares(virtiofs_mounts);
+
+            state = State::running;
+            update_state();
+            update_shutdown_status = previous_update_shutdown_status;
+
+            throw std::runtime_error(
+                fmt::format("QEMU did not unplug the virtiofs devices of {} in time, suspension aborted", vm_name));
+        }
+
         drop_ssh_session();
-        vm_process->write(hmc_to_qmp_json(QString{"savevm "} + suspend_tag));
         vm_process->wait_for_finished(shutdown_timeout);
 
         vm_process.reset(nullptr);
@@ -548,64 +655,364 @@ std::string mp::QemuVirtualMachine::ipv6()
     return {};
 }
 
+std::vector<std::string> mp::QemuVirtualMachine::get_all_ipv4()
+{
+    if (!guest_agent_socket.isEmpty() && MP_UTILS.is_running(current_state()))
+    {
+        std::unique_lock lock{guest_agent_mutex};
+        if (std::chrono::steady_clock::now() >= guest_agent_retry_time)
+        {
+            lock.unlock();
+            try
+            {
+                return QemuGuestAgent{guest_agent_socket}.get_all_ipv4();
+            }
+            catch (const std::runtime_error& e)
+            {
+                // the agent is optional in the guest, so don't keep waiting on it
+                mpl::log(mpl::Level::debug, vm_name, fmt::format("Guest agent unavailable, using SSH: {}", e.what()));
+
+                lock.lock();
+                guest_agent_retry_time = std::chrono::steady_clock::now() + guest_agent_retry_interval;
+            }
+        }
+    }
+
+    return BaseVirtualMachine::get_all_ipv4();
+}
+
 void mp::QemuVirtualMachine::wait_until_ssh_up(std::chrono::milliseconds timeout)
 {
     BaseVirtualMachine::wait_until_ssh_up(timeout);
 
     if (is_starting_from_suspend)
     {
+        // the guest is running by now, so it picks the devices up before the daemon mounts them again
+        plug_virtiofs_shares();
         emit on_delete_memory_snapshot();
         emit on_synchronize_clock();
     }
 }
 
+void mp::QemuVirtualMachine::on_migration_status(const QString& status)
+{
+    if (status == "completed")
+    {
+        migrating_to_state_file = false;
+        QFile::remove(suspend_state_file);
+        if (!QFile::rename(suspend_state_file + partial_state_suffix, suspend_state_file))
+        {
+            // keep the VM around, it is paused but nothing was lost
+            mpl::log(mpl::Level::error, vm_name, "Failed to store the suspend state file");
+            savevm_fallback_pending = true;
+            qmp->execute("cont");
+            return;
+        }
+
+        vm_process->kill();
+        on_suspend();
+    }
+    else if (status == "failed")
+    {
+        migrating_to_state_file = false;
+        mpl::log(mpl::Level::warning, vm_name, "Failed to write the suspend state file, falling back to savevm");
+        QFile::remove(suspend_state_file + partial_state_suffix);
+        savevm_fallback_pending = true;
+        qmp->execute("cont");
+    }
+}
+
+void mp::QemuVirtualMachine::on_incoming_migration_status(const QString& status)
+{
+    if (status == "completed")
+    {
+        // the guest was stopped when its state was written out, so it needs to be told to carry on
+        migrating_from_state_file = false;
+        qmp->execute("cont");
+    }
+    else if (status == "failed")
+    {
+        migrating_from_state_file = false;
+        mpl::log(mpl::Level::error, vm_name, "Failed to restore the suspend state file");
+    }
+}
+
+void mp::QemuVirtualMachine::write_suspend_commands()
+{
+    if (suspend_to_file)
+    {
+        migrating_to_state_file = true;
+        write_migrate_to_file(*qmp, suspend_state_file);
+    }
+    else
+        execute_hmc(*qmp, QString{"savevm "} + suspend_tag);
+}
+
+// virtiofsd serves a single connection, so a new one is needed for every QEMU process
+void mp::QemuVirtualMachine::start_virtiofsd()
+{
+    virtiofsd_processes.clear();
+
+    for (const auto& [tag, share] : virtiofs_shares)
+        start_virtiofsd_for(tag, share);
+}
+
+void mp::QemuVirtualMachine::start_virtiofsd_for(const std::string& tag, const VirtiofsShare& share)
+{
+    QFile::remove(share.socket_path); // left behind if virtiofsd did not exit cleanly
+
+    auto process = mp::platform::make_process(std::make_unique<VirtiofsdProcessSpec>(tag, share));
+    QObject::connect(process.get(), &Process::finished, [this, tag = tag](ProcessState process_state) {
+        if (!process_state.completed_successfully())
+            mpl::log(mpl::Level::warning, vm_name,
+                     fmt::format("virtiofsd for mount '{}' stopped: {}", tag, process_state.failure_message()));
+    });
+
+    process->start();
+    if (!process->wait_for_started())
+        throw std::runtime_error(fmt::format("failed to start virtiofsd: {}", process->error_string()));
+
+    // QEMU fails to start if the socket is not there to connect to
+    const auto deadline = std::chrono::steady_clock::now() + virtiofsd_socket_timeout;
+    while (!QFile::exists(share.socket_path))
+    {
+        if (!process->running() || std::chrono::steady_clock::now() > deadline)
+            throw std::runtime_error(fmt::format("virtiofsd did not come up for mount '{}': {}",
+                                                 tag,
+                                                 process->read_all_standard_error()));
+        std::this_thread::sleep_for(10ms);
+    }
+
+    virtiofsd_processes.insert_or_assign(tag, std::move(process));
+}
+
+// vhost-user-fs devices cannot be saved, so they are unplugged for the duration of a suspension
+void mp::QemuVirtualMachine::plug_virtiofs_shares()
+{
+    for (const auto& [tag, share] : virtiofs_shares)
+        plug_virtiofs_share(tag, share);
+}
+
+void mp::QemuVirtualMachine::plug_virtiofs_share(const std::string& tag, const VirtiofsShare& share)
+{
+    const auto id = QString::fromStdString(tag);
+    const auto backend = QJsonObject{{"type", "unix"}, {"data", QJsonObject{{"path", share.socket_path}}}};
+    const auto socket = QJsonObject{{"addr", backend}, {"server", false}};
+    const auto chardev = QJsonObject{{"type", "socket"}, {"data", socket}};
+
+    qmp->execute("chardev-add", {{"id", id}, {"backend", chardev}});
+    qmp->execute("device_add", {{"driver", "vhost-user-fs-pci"}, {"id", id}, {"chardev", id}, {"tag", id}});
+}
+
+// Throws if the guest cannot unmount the shares, in which case their devices must stay. Returns the mount points, by
+// tag, to restore should the suspension not go ahead after all
+std::vector<std::pair<std::string, std::string>> mp::QemuVirtualMachine::unmount_virtiofs_shares()
+{
+    std::vector<std::pair<std::string, std::string>> mounts;
+    if (virtiofs_shares.empty())
+        return mounts;
+
+    const auto mount_table =
+        ssh_exec("findmnt --list --raw --noheadings --types virtiofs --output SOURCE,TARGET || true");
+    for (const auto& line : QString::fromStdString(mount_table).split('\n', Qt::SkipEmptyParts))
+    {
+        const auto fields = line.split(' ', Qt::SkipEmptyParts);
+        if (fields.size() == 2 && virtiofs_shares.count(fields[0].toStdString()))
+            mounts.emplace_back(fields[0].toStdString(), fields[1].toStdString());
+    }
+
+    try
+    {
+        ssh_exec("sudo umount --all --types virtiofs");
+    }
+    catch (const std::exception& e)
+    {
+        remount_virtiofs_shares(mounts); // umount may have let go of some before failing
+        throw std::runtime_error(fmt::format("Cannot suspend {}: failed to unmount its virtiofs shares: {}",
+                                             vm_name,
+                                             e.what()));
+    }
+
+    return mounts;
+}
+
+void mp::QemuVirtualMachine::remount_virtiofs_shares(const std::vector<std::pair<std::string, std::string>>& mounts)
+{
+    for (const auto& [tag, target] : mounts)
+    {
+        try
+        {
+            ssh_exec(fmt::format("findmnt --types virtiofs {} || sudo mount -t virtiofs {} {}", target, tag, target));
+        }
+        catch (const std::exception& e)
+        {
+            mpl::log(mpl::Level::warning,
+                     vm_name,
+                     fmt::format("Failed to mount virtiofs share '{}' back at {}: {}", tag, target, e.what()));
+        }
+    }
+}
+
+bool mp::QemuVirtualMachine::unplug_virtiofs_shares()
+{
+    pending_virtiofs_unplugs.clear();
+    for (const auto& [tag, _] : virtiofs_shares)
+        pending_virtiofs_unplugs.insert(tag);
+
+    for (const auto& tag : pending_virtiofs_unplugs)
+        qmp->execute("device_del", {{"id", QString::fromStdString(tag)}});
+
+    return !pending_virtiofs_unplugs.empty();
+}
+
+// QEMU's output is handled while waiting for it, so this keeps track of DEVICE_DELETED events, up to a deadline
+bool mp::QemuVirtualMachine::wait_for_virtiofs_unplugs()
+{
+    const auto deadline = std::chrono::steady_clock::now() + virtiofs_unplug_timeout;
+    while (!pending_virtiofs_unplugs.empty())
+    {
+        const auto remaining =
+            std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (remaining <= 0ms || !vm_process->wait_for_ready_read(remaining.count()))
+            break;
+    }
+
+    if (pending_virtiofs_unplugs.empty())
+        return true;
+
+    mpl::log(mpl::Level::warning,
+             vm_name,
+             fmt::format("Gave up waiting for virtiofs devices to be unplugged: {}",
+                         fmt::join(pending_virtiofs_unplugs.cbegin(), pending_virtiofs_unplugs.cend(), ", ")));
+    return false;
+}
+
+// Devices that QEMU did drop lost their virtiofsd connection as well, so they are brought back from scratch
+void mp::QemuVirtualMachine::restore_virtiofs_shares(const std::vector<std::pair<std::string, std::string>>& mounts)
+{
+    for (const auto& [tag, share] : virtiofs_shares)
+    {
+        if (pending_virtiofs_unplugs.count(tag))
+            continue;
+
+        try
+        {
+            qmp->execute("chardev-remove", {{"id", QString::fromStdString(tag)}});
+            start_virtiofsd_for(tag, share);
+            plug_virtiofs_share(tag, share);
+        }
+        catch (const std::exception& e)
+        {
+            mpl::log(mpl::Level::warning,
+                     vm_name,
+                     fmt::format("Failed to plug virtiofs share '{}' back: {}", tag, e.what()));
+        }
+    }
+
+    pending_virtiofs_unplugs.clear();
+    remount_virtiofs_shares(mounts);
+}
+
+void mp::QemuVirtualMachine::adjust_balloon()
+{
+    if (state != State::running || !vm_process)
+        return;
+
+    if (const auto pressure = QemuBalloonPolicy::host_memory_pressure())
+    {
+        if (const auto target = balloon_policy.next_target(*pressure, desc.mem_size))
+        {
+            mpl::log(mpl::Level::debug,
+                     vm_name,
+                     fmt::format("Host memory pressure at {}%, balloon target now {} bytes", *pressure, *target));
+            qmp->execute("balloon", {{"value", *target}});
+        }
+    }
+}
+
+void mp::QemuVirtualMachine::on_qmp_event(const QString& event, const QJsonObject& data)
+{
+    if (event == "RESET" && state != State::restarting)
+    {
+        mpl::log(mpl::Level::info, vm_name, "VM restarting");
+        on_restart();
+    }
+    else if (event == "POWERDOWN")
+    {
+        mpl::log(mpl::Level::info, vm_name, "VM powering down");
+    }
+    else if (event == "SHUTDOWN")
+    {
+        mpl::log(mpl::Level::info, vm_name, "VM shut down");
+    }
+    else if (event == "STOP")
+    {
+        mpl::log(mpl::Level::info, vm_name, "VM suspending");
+    }
+    else if (event == "MIGRATION" && migrating_to_state_file)
+    {
+        // savevm reports migration events too, so only those of our own migration are followed
+        on_migration_status(data["status"].toString());
+    }
+    else if (event == "MIGRATION" && migrating_from_state_file)
+    {
+        on_incoming_migration_status(data["status"].toString());
+    }
+    else if (event == "DEVICE_DELETED" && !pending_virtiofs_unplugs.empty())
+    {
+        pending_virtiofs_unplugs.erase(data["device"].toString().toStdString());
+    }
+    else if (event == "RESUME")
+    {
+        if (savevm_fallback_pending)
+        {
+            savevm_fallback_pending = false;
+            execute_hmc(*qmp, QString{"savevm "} + suspend_tag);
+            return;
+        }
+
+        mpl::log(mpl::Level::info, vm_name, "VM suspended");
+        if (state == State::suspending || state == State::running)
+        {
+            vm_process->kill();
+            on_suspend();
+        }
+    }
+}
+
 void mp::QemuVirtualMachine::initialize_vm_process()
 {
-    vm_process = make_qemu_process(
-        desc,
-        ((state == State::suspended) ? std::make_optional(monitor->retrieve_metadata_for(vm_name)) : std::nullopt),
-        mount_args, qemu_platform->vm_platform_args(desc));
+    resuming_from_state_file = state == State::suspended && QFile::exists(suspend_state_file);
+    migrating_from_state_file = false;
+    const auto resume_metadata =
+        (state == State::suspended) ? std::make_optional(monitor->retrieve_metadata_for(vm_name)) : std::nullopt;
+
+    // A suspended instance resumes with the NIC it was suspended with, so it needs a tap device to match
+    auto platform_desc = desc;
+    if (resume_metadata && !get_arguments(*resume_metadata).join(' ').contains("queues="))
+        platform_desc.num_cores = 1;
+
+    vm_process = make_qemu_process(desc, resume_metadata, mount_args, qemu_platform->vm_platform_args(platform_desc),
+                                   guest_agent_socket, suspend_state_file, resuming_from_state_file);
 
     QObject::connect(vm_process.get(), &Process::started, [this]() {
         mpl::log(mpl::Level::info, vm_name, "process started");
         on_started();
     });
 
+    // the previous process is gone, and so is anything it still owed us
+    qmp = std::make_unique<QmpClient>(
+        [this](const QByteArray& data) {
+            if (vm_process)
+                vm_process->write(data);
+        },
+        [this](const QString& event, const QJsonObject& data) { on_qmp_event(event, data); });
+
     QObject::connect(vm_process.get(), &Process::ready_read_standard_output, [this]() {
         auto qmp_output = vm_process->read_all_standard_output();
         mpl::log(mpl::Level::debug, vm_name, fmt::format("QMP: {}", qmp_output));
-        auto qmp_object = QJsonDocument::fromJson(qmp_output.split('\n').first()).object();
-        auto event = qmp_object["event"];
 
-        if (!event.isNull())
-        {
-            if (event.toString() == "RESET" && state != State::restarting)
-            {
-                mpl::log(mpl::Level::info, vm_name, "VM restarting");
-                on_restart();
-            }
-            else if (event.toString() == "POWERDOWN")
-            {
-                mpl::log(mpl::Level::info, vm_name, "VM powering down");
-            }
-            else if (event.toString() == "SHUTDOWN")
-            {
-                mpl::log(mpl::Level::info, vm_name, "VM shut down");
-            }
-            else if (event.toString() == "STOP")
-            {
-                mpl::log(mpl::Level::info, vm_name, "VM suspending");
-            }
-            else if (event.toString() == "RESUME")
-            {
-                mpl::log(mpl::Level::info, vm_name, "VM suspended");
-                if (state == State::suspending || state == State::running)
-                {
-                    vm_process->kill();
-                    on_suspend();
-                }
-            }
-        }
+        qmp->handle_output(qmp_output);
     });
 
     QObject::connect(vm_process.get(), &Process::ready_read_standard_error, [this]() {
@@ -631,6 +1038,8 @@ void mp::QemuVirtualMachine::initialize_vm_process()
         });
 
     QObject::connect(vm_process.get(), &Process::finished, [this](ProcessState process_state) {
+        qmp->abandon_pending("QEMU exited");
+
         if (process_state.exit_code)
         {
             mpl::log(mpl::Level::info, vm_name,
@@ -676,6 +1085,21 @@ void mp::QemuVirtualMachine::resize_disk(const MemorySize& new_size)
     desc.disk_space = new_size;
 }
 
+void mp::QemuVirtualMachine::update_disk_profile(const std::string& profile)
+{
+    const auto profiles = QemuVMProcessSpec::disk_profiles();
+    if (!profiles.contains(QString::fromStdString(profile)))
+        throw std::invalid_argument{fmt::format("Unknown disk profile, valid options are: {}", profiles.join(", "))};
+
+    desc.disk_profile = profile;
+}
+
+void mp::QemuVirtualMachine::update_memory_profile(const std::string& profile)
+{
+    QemuMemoryProfile::parse(profile);
+    desc.memory_profile = profile;
+}
+
 void mp::QemuVirtualMachine::add_network_interface(int /* not used on this backend */,
                                                    const std::string& default_mac_addr,
                                                    const NetworkInterface& extra_interface)
@@ -695,6 +1119,30 @@ mp::QemuVirtualMachine::MountArgs& mp::QemuVirtualMachine::modifiable_mount_args
     return mount_args;
 }
 
+mp::QemuVirtualMachine::VirtiofsShares& mp::QemuVirtualMachine::modifiable_virtiofs_shares()
+{
+    return virtiofs_shares;
+}
+
+bool mp::QemuVirtualMachine::uses_virtiofs_mounts() const
+{
+    if (!virtiofs_mounts)
+        return false;
+
+    try
+    {
+        check_virtiofsd_usable();
+        return true;
+    }
+    catch (const std::runtime_error& e)
+    {
+        mpl::log(mpl::Level::warning,
+                 vm_name,
+                 fmt::format("Cannot use virtiofs for native mounts, falling back to 9p: {}", e.what()));
+        return false;
+    }
+}
+
 auto mp::QemuVirtualMachine::make_specific_snapshot(const std::string& snapshot_name,
                                                     const std::string& comment,
                                                     const std::string& instance_id,
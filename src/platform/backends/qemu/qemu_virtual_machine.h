@@ -18,7 +18,10 @@
 #ifndef MULTIPASS_QEMU_VIRTUAL_MACHINE_H
 #define MULTIPASS_QEMU_VIRTUAL_MACHINE_H
 
+#include "qemu_balloon_policy.h"
 #include "qemu_platform.h"
+#include "qemu_qmp_client.h"
+#include "virtiofsd_process_spec.h"
 
 #include <shared/base_virtual_machine.h>
 
@@ -28,8 +31,15 @@
 
 #include <QObject>
 #include <QStringList>
+#include <QTimer>
 
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace multipass
 {
@@ -41,12 +51,16 @@ class QemuVirtualMachine : public QObject, public BaseVirtualMachine
     Q_OBJECT
 public:
     using MountArgs = std::unordered_map<std::string, std::pair<std::string, QStringList>>;
+    using VirtiofsShares = std::unordered_map<std::string, VirtiofsShare>;
 
     QemuVirtualMachine(const VirtualMachineDescription& desc,
                        QemuPlatform* qemu_platform,
                        VMStatusMonitor& monitor,
                        const SSHKeyProvider& key_provider,
-                       const Path& instance_dir);
+                       const Path& instance_dir,
+                       bool suspend_to_file = false,
+                       bool virtiofs_mounts = false,
+                       bool balloon_on_pressure = false);
     ~QemuVirtualMachine();
 
     void start() override;
@@ -58,16 +72,21 @@ public:
     std::string ssh_username() override;
     std::string management_ipv4() override;
     std::string ipv6() override;
+    std::vector<std::string> get_all_ipv4() override;
     void ensure_vm_is_running() override;
     void wait_until_ssh_up(std::chrono::milliseconds timeout) override;
     void update_state() override;
     void update_cpus(int num_cores) override;
     void resize_memory(const MemorySize& new_size) override;
     void resize_disk(const MemorySize& new_size) override;
+    void update_disk_profile(const std::string& profile) override;
+    void update_memory_profile(const std::string& profile) override;
     virtual void add_network_interface(int index,
                                        const std::string& default_mac_addr,
                                        const NetworkInterface& extra_interface) override;
     virtual MountArgs& modifiable_mount_args();
+    virtual VirtiofsShares& modifiable_virtiofs_shares();
+    virtual bool uses_virtiofs_mounts() const;
     std::unique_ptr<MountHandler> make_native_mount_handler(const std::string& target, const VMMount& mount) override;
 
 signals:
@@ -97,18 +116,49 @@ private:
     void on_suspend();
     void on_restart();
     void initialize_vm_process();
+    void on_qmp_event(const QString& event, const QJsonObject& data);
+    void on_migration_status(const QString& status);
+    void on_incoming_migration_status(const QString& status);
+    void write_suspend_commands();
+    void start_virtiofsd();
+    void start_virtiofsd_for(const std::string& tag, const VirtiofsShare& share);
+    void plug_virtiofs_shares();
+    void plug_virtiofs_share(const std::string& tag, const VirtiofsShare& share);
+    std::vector<std::pair<std::string, std::string>> unmount_virtiofs_shares();
+    void remount_virtiofs_shares(const std::vector<std::pair<std::string, std::string>>& mounts);
+    bool unplug_virtiofs_shares();
+    bool wait_for_virtiofs_unplugs();
+    void restore_virtiofs_shares(const std::vector<std::pair<std::string, std::string>>& mounts);
+    void adjust_balloon();
 
     VirtualMachineDescription desc;
     std::unique_ptr<Process> vm_process{nullptr};
+    std::unique_ptr<QmpClient> qmp; // talks to vm_process, kept until the next one replaces it
     const std::string mac_addr;
     const std::string username;
     QemuPlatform* qemu_platform;
     VMStatusMonitor* monitor;
     MountArgs mount_args;
+    VirtiofsShares virtiofs_shares;
+    std::unordered_map<std::string, std::unique_ptr<Process>> virtiofsd_processes;
+    std::set<std::string> pending_virtiofs_unplugs; // suspending waits, for a while, for these devices to be gone
     std::string saved_error_msg;
     bool update_shutdown_status{true};
     bool is_starting_from_suspend{false};
     std::chrono::steady_clock::time_point network_deadline;
+    const QString guest_agent_socket;
+    std::mutex guest_agent_mutex;
+    std::chrono::steady_clock::time_point guest_agent_retry_time; // guest agent skipped until then, after failures
+    const QString suspend_state_file;
+    const bool suspend_to_file{false}; // migrate memory out to suspend_state_file, instead of savevm into the image
+    bool resuming_from_state_file{false};
+    bool migrating_to_state_file{false};
+    bool migrating_from_state_file{false};
+    bool savevm_fallback_pending{false}; // migrating to the state file failed, savevm once the VM is running again
+    const bool virtiofs_mounts{false};   // new native mounts use virtiofs instead of 9p
+    const bool balloon_on_pressure{false}; // follow host memory pressure with the balloon
+    QemuBalloonPolicy balloon_policy;
+    QTimer balloon_timer{this}; // a child, so that it moves along with the instance to the daemon thread
 };
 } // namespace multipass
 
@@ -36,15 +36,29 @@ namespace
 constexpr auto category = "qemu factory";
 } // namespace
 
-mp::QemuVirtualMachineFactory::QemuVirtualMachineFactory(const mp::Path& data_dir)
-    : QemuVirtualMachineFactory{MP_QEMU_PLATFORM_FACTORY.make_qemu_platform(data_dir), data_dir}
+mp::QemuVirtualMachineFactory::QemuVirtualMachineFactory(const mp::Path& data_dir,
+                                                         bool suspend_to_file,
+                                                         bool virtiofs_mounts,
+                                                         bool balloon_on_pressure)
+    : QemuVirtualMachineFactory{MP_QEMU_PLATFORM_FACTORY.make_qemu_platform(data_dir),
+                                data_dir,
+                                suspend_to_file,
+                                virtiofs_mounts,
+                                balloon_on_pressure}
 {
 }
 
-mp::QemuVirtualMachineFactory::QemuVirtualMachineFactory(QemuPlatform::UPtr qemu_platform, const mp::Path& data_dir)
+mp::QemuVirtualMachineFactory::QemuVirtualMachineFactory(QemuPlatform::UPtr qemu_platform,
+                                                         const mp::Path& data_dir,
+                                                         bool suspend_to_file,
+                                                         bool virtiofs_mounts,
+                                                         bool balloon_on_pressure)
     : BaseVirtualMachineFactory(
           MP_UTILS.derive_instances_dir(data_dir, qemu_platform->get_directory_name(), instances_subdir)),
-      qemu_platform{std::move(qemu_platform)}
+      qemu_platform{std::move(qemu_platform)},
+      suspend_to_file{suspend_to_file},
+      virtiofs_mounts{virtiofs_mounts},
+      balloon_on_pressure{balloon_on_pressure}
 {
 }
 
@@ -56,7 +70,10 @@ mp::VirtualMachine::UPtr mp::QemuVirtualMachineFactory::create_virtual_machine(c
                                                     qemu_platform.get(),
                                                     monitor,
                                                     key_provider,
-                                                    get_instance_directory(desc.vm_name));
+                                                    get_instance_directory(desc.vm_name),
+                                                    suspend_to_file,
+                                                    virtiofs_mounts,
+                                                    balloon_on_pressure);
 }
 
 void mp::QemuVirtualMachineFactory::remove_resources_for_impl(const std::string& name)
@@ -31,7 +31,10 @@ namespace multipass
 class QemuVirtualMachineFactory final : public BaseVirtualMachineFactory
 {
 public:
-    explicit QemuVirtualMachineFactory(const Path& data_dir);
+    explicit QemuVirtualMachineFactory(const Path& data_dir,
+                                       bool suspend_to_file = false,
+                                       bool virtiofs_mounts = false,
+                                       bool balloon_on_pressure = false);
 
     VirtualMachine::UPtr create_virtual_machine(const VirtualMachineDescription& desc,
                                                 const SSHKeyProvider& key_provider,
@@ -43,15 +46,23 @@ public:
     QString get_backend_directory_name() const override;
     std::vector<NetworkInterfaceInfo> networks() const override;
     void require_snapshots_support() const override;
+    bool supports_concurrent_vm_creation() const override;
     void prepare_networking(std::vector<NetworkInterface>& extra_interfaces) override;
 
 protected:
     void remove_resources_for_impl(const std::string& name) override;
 
 private:
-    QemuVirtualMachineFactory(QemuPlatform::UPtr qemu_platform, const Path& data_dir);
+    QemuVirtualMachineFactory(QemuPlatform::UPtr qemu_platform,
+                              const Path& data_dir,
+                              bool suspend_to_file,
+                              bool virtiofs_mounts,
+                              bool balloon_on_pressure);
 
     QemuPlatform::UPtr qemu_platform;
+    const bool suspend_to_file;
+    const bool virtiofs_mounts;
+    const bool balloon_on_pressure;
 };
 } // namespace multipass
 
@@ -59,4 +70,9 @@ inline void multipass::QemuVirtualMachineFactory::require_snapshots_support() co
 {
 }
 
+inline bool multipass::QemuVirtualMachineFactory::supports_concurrent_vm_creation() const
+{
+    return true;
+}
+
 #endif // MULTIPASS_QEMU_VIRTUAL_MACHINE_FACTORY_H
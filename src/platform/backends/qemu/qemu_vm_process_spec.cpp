@@ -16,24 +16,84 @@
  */
 
 #include "qemu_vm_process_spec.h"
+#include "qemu_memory_profile.h"
+#include "virtiofsd_process_spec.h"
 
+#include <multipass/constants.h>
 #include <multipass/exceptions/snap_environment_exception.h>
 #include <multipass/format.h>
 #include <multipass/logging/log.h>
 #include <multipass/snap_utils.h>
 #include <shared/linux/backend_utils.h>
 
+#include <algorithm>
+
 namespace mp = multipass;
 namespace mpl = multipass::logging;
 namespace mpu = multipass::utils;
 
+namespace
+{
+bool has_virtiofs_mounts(const mp::QemuVirtualMachine::MountArgs& mount_args)
+{
+    return std::any_of(mount_args.cbegin(), mount_args.cend(), [](const auto& mount) {
+        return mp::is_virtiofs_mount(mount.second.second);
+    });
+}
+
+QString virtiofs_socket_from(const QStringList& mount_args)
+{
+    for (const auto& arg : mount_args)
+        if (arg.startsWith("socket,"))
+            return arg.section("path=", 1);
+
+    return QString{};
+}
+} // namespace
+
 mp::QemuVMProcessSpec::QemuVMProcessSpec(const mp::VirtualMachineDescription& desc, const QStringList& platform_args,
                                          const mp::QemuVirtualMachine::MountArgs& mount_args,
-                                         const std::optional<ResumeData>& resume_data)
-    : desc{desc}, platform_args{platform_args}, mount_args{mount_args}, resume_data{resume_data}
+                                         const std::optional<ResumeData>& resume_data,
+                                         const QString& guest_agent_socket,
+                                         const QString& suspend_state_file)
+    : desc{desc},
+      platform_args{platform_args},
+      mount_args{mount_args},
+      resume_data{resume_data},
+      guest_agent_socket{guest_agent_socket},
+      suspend_state_file{suspend_state_file}
 {
 }
 
+namespace
+{
+// Profiles other than the default attach the image as virtio-blk on a dedicated iothread, bypassing the host page
+// cache, with one queue per vCPU. The profile name selects the AIO engine, both of which are Linux-only.
+QStringList disk_arguments(const mp::VirtualMachineDescription& desc)
+{
+    const auto drive = QString{"file=%1,if=none,format=qcow2,discard=unmap,id=hda"}.arg(desc.image.image_path);
+
+    if (desc.disk_profile == mp::default_disk_profile)
+        return {"-device", "virtio-scsi-pci,id=scsi0", "-drive", drive, "-device", "scsi-hd,drive=hda,bus=scsi0.0"};
+
+    return {"-object",
+            "iothread,id=iothread0",
+            "-drive",
+            QString{"%1,cache=none,aio=%2"}.arg(drive, QString::fromStdString(desc.disk_profile)),
+            "-device",
+            QString{"virtio-blk-pci,drive=hda,iothread=iothread0,num-queues=%1"}.arg(desc.num_cores)};
+}
+} // namespace
+
+QStringList mp::QemuVMProcessSpec::disk_profiles()
+{
+#ifdef MULTIPASS_PLATFORM_LINUX
+    return {mp::default_disk_profile, "native", "io_uring"};
+#else
+    return {mp::default_disk_profile};
+#endif
+}
+
 QStringList mp::QemuVMProcessSpec::arguments() const
 {
     QStringList args;
@@ -43,7 +103,11 @@ QStringList mp::QemuVMProcessSpec::arguments() const
         args = resume_data->arguments;
 
         // need to append extra arguments for resume
-        args << "-loadvm" << resume_data->suspend_tag;
+        if (resume_data->from_state_file && !suspend_state_file.isEmpty())
+            args << "-incoming"
+                 << "defer"; // the state file is migrated in over QMP, once migration events are enabled
+        else
+            args << "-loadvm" << resume_data->suspend_tag;
 
         QString machine_type = resume_data->machine_type;
         if (!machine_type.isEmpty())
@@ -67,15 +131,18 @@ QStringList mp::QemuVMProcessSpec::arguments() const
 
         args << platform_args;
         // The VM image itself
-        args << "-device"
-             << "virtio-scsi-pci,id=scsi0"
-             << "-drive" << QString("file=%1,if=none,format=qcow2,discard=unmap,id=hda").arg(desc.image.image_path)
-             << "-device"
-             << "scsi-hd,drive=hda,bus=scsi0.0";
+        args << disk_arguments(desc);
         // Number of cpu cores
         args << "-smp" << QString::number(desc.num_cores);
         // Memory to use for VM
         args << "-m" << mem_size;
+        // How that memory is backed; vhost-user devices need guest memory that virtiofsd can map as well
+        const auto memory_profile = QemuMemoryProfile::parse(desc.memory_profile);
+        args << memory_profile.backend_arguments(desc.mem_size, has_virtiofs_mounts(mount_args));
+        // Hand memory the guest frees back to the host, unless it is meant to stay allocated
+        if (memory_profile.backing == mp::default_memory_profile)
+            args << "-device"
+                 << "virtio-balloon-pci,id=balloon0,deflate-on-oom=on,free-page-reporting=on";
         // Control interface
         args << "-qmp"
              << "stdio";
@@ -89,11 +156,23 @@ QStringList mp::QemuVMProcessSpec::arguments() const
              << "-nographic";
         // Cloud-init disk
         args << "-cdrom" << desc.cloud_init_iso;
+        // Guest agent channel
+        if (!guest_agent_socket.isEmpty())
+            args << "-chardev" << QString{"socket,path=%1,server=on,wait=off,id=qga0"}.arg(guest_agent_socket)
+                 << "-device"
+                 << "virtio-serial"
+                 << "-device"
+                 << "virtserialport,chardev=qga0,name=org.qemu.guest_agent.0";
     }
 
     for (const auto& [_, mount_data] : mount_args)
     {
         const auto& [__, mount_args] = mount_data;
+
+        // virtiofs devices were unplugged to suspend, the VM plugs them back in once resumed
+        if (resume_data && is_virtiofs_mount(mount_args))
+            continue;
+
         args << mount_args;
     }
 
@@ -130,6 +209,7 @@ profile %1 flags=(attach_disconnected) {
   signal (receive) peer=%2,
 
   /dev/net/tun rw,
+  /dev/vhost-net rw,
   /dev/kvm rw,
   /dev/ptmx rw,
   /dev/kqemu rw,
@@ -175,6 +255,8 @@ profile %1 flags=(attach_disconnected) {
   # Disk images
   %6 rwk,  # QCow2 filesystem image
   %7 rk,   # cloud-init ISO
+  %9
+  %10
 
   # allow full access just to user-specified mount directories on the host
   %8
@@ -186,10 +268,26 @@ profile %1 flags=(attach_disconnected) {
     QString signal_peer; // who can send kill signal to qemu
     QString firmware;    // location of bootloader firmware needed by qemu
     QString mount_dirs;  // directories on host that are mounted
+    QString agent_rule;  // guest agent socket, if any
+    QString state_rule;  // suspend state file, if any
+
+    if (!guest_agent_socket.isEmpty())
+        agent_rule = guest_agent_socket + " rw,  # guest agent socket";
+
+    if (!suspend_state_file.isEmpty())
+        state_rule = suspend_state_file + "{,.part} rw,  # suspend state";
 
     for (const auto& [_, mount_data] : mount_args)
     {
-        const auto& [source_path, __] = mount_data;
+        const auto& [source_path, args] = mount_data;
+
+        // with virtiofs, the files are served by virtiofsd
+        if (is_virtiofs_mount(args))
+        {
+            mount_dirs += virtiofs_socket_from(args) + " rw,\n  ";
+            continue;
+        }
+
         mount_dirs += QString::fromStdString(source_path) + "/ rw,\n  ";
         mount_dirs += QString::fromStdString(source_path) + "/** rwlk,\n  ";
     }
@@ -207,7 +305,7 @@ profile %1 flags=(attach_disconnected) {
     }
 
     return profile_template.arg(apparmor_profile_name(), signal_peer, firmware, root_dir, program(),
-                                desc.image.image_path, desc.cloud_init_iso, mount_dirs);
+                                desc.image.image_path, desc.cloud_init_iso, mount_dirs, agent_rule, state_rule);
 }
 
 QString mp::QemuVMProcessSpec::identifier() const
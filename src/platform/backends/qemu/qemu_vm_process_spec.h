@@ -38,13 +38,17 @@ public:
         QString machine_type;
         bool use_cdrom_flag; // to be removed, should be replaced by "arguments"
         QStringList arguments;
+        bool from_state_file = false; // migrate in from the suspend state file, instead of loading suspend_tag
     };
 
     static QString default_machine_type();
+    static QStringList disk_profiles();
 
     explicit QemuVMProcessSpec(const VirtualMachineDescription& desc, const QStringList& platform_args,
                                const QemuVirtualMachine::MountArgs& mount_args,
-                               const std::optional<ResumeData>& resume_data);
+                               const std::optional<ResumeData>& resume_data,
+                               const QString& guest_agent_socket = {},
+                               const QString& suspend_state_file = {});
 
     QStringList arguments() const override;
 
@@ -56,6 +60,8 @@ private:
     const QStringList platform_args;
     const QemuVirtualMachine::MountArgs mount_args;
     const std::optional<ResumeData> resume_data;
+    const QString guest_agent_socket;
+    const QString suspend_state_file;
 };
 
 } // namespace multipass
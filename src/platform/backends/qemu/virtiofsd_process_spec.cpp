@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "virtiofsd_process_spec.h"
+
+#include <multipass/exceptions/snap_environment_exception.h>
+#include <multipass/format.h>
+#include <multipass/platform.h>
+#include <multipass/process/simple_process_spec.h>
+#include <multipass/snap_utils.h>
+
+#include <QRegularExpression>
+#include <QStandardPaths>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace mp = multipass;
+namespace mpu = multipass::utils;
+
+namespace
+{
+constexpr auto min_virtiofsd_version = std::make_pair(1, 11); // --translate-uid and --translate-gid
+
+QString snap_root_dir()
+{
+    try
+    {
+        return mpu::snap_dir();
+    }
+    catch (const mp::SnapEnvironmentException&)
+    {
+        return QString{};
+    }
+}
+
+QString virtiofsd_program()
+{
+    // Distributions install virtiofsd next to QEMU's other helpers, outside of $PATH
+    const auto root_dir = snap_root_dir();
+    for (const auto& paths : {QStringList{}, QStringList{root_dir + "/usr/libexec", root_dir + "/usr/lib/qemu"}})
+        if (const auto found = QStandardPaths::findExecutable("virtiofsd", paths); !found.isEmpty())
+            return found;
+
+    return "virtiofsd";
+}
+} // namespace
+
+bool mp::is_virtiofs_mount(const QStringList& mount_args)
+{
+    return std::any_of(mount_args.cbegin(), mount_args.cend(),
+                       [](const QString& arg) { return arg.startsWith("vhost-user-fs-pci,"); });
+}
+
+void mp::check_virtiofsd_usable()
+{
+    // QEMU dropped its own virtiofsd in 8.0, so it is not necessarily installed alongside it
+    auto process = mp::platform::make_process(simple_process_spec(virtiofsd_program(), {"--version"}));
+    const auto exit_state = process->execute();
+    if (!exit_state.completed_successfully())
+        throw std::runtime_error{fmt::format("virtiofsd is not installed ({})", exit_state.failure_message())};
+
+    const auto output = process->read_all_standard_output();
+    const auto match = QRegularExpression{"virtiofsd v?(\\d+)\\.(\\d+)"}.match(output);
+    if (!match.hasMatch())
+        throw std::runtime_error{fmt::format("cannot tell the virtiofsd version from '{}'", output.trimmed())};
+
+    const auto version = std::make_pair(match.captured(1).toInt(), match.captured(2).toInt());
+    if (version < min_virtiofsd_version)
+        throw std::runtime_error{fmt::format("virtiofsd {}.{} is too old, {}.{} or later is needed to map ids",
+                                             version.first,
+                                             version.second,
+                                             min_virtiofsd_version.first,
+                                             min_virtiofsd_version.second)};
+}
+
+mp::VirtiofsdProcessSpec::VirtiofsdProcessSpec(const std::string& tag, const VirtiofsShare& share)
+    : tag{tag}, share{share}
+{
+}
+
+QString mp::VirtiofsdProcessSpec::program() const
+{
+    return virtiofsd_program();
+}
+
+QStringList mp::VirtiofsdProcessSpec::arguments() const
+{
+    // virtiofsd maps ids from the guest to the host, the other way around from the 9p mapping options
+    const auto& [host_uid, instance_uid] = share.uid_map;
+    const auto& [host_gid, instance_gid] = share.gid_map;
+
+    return {QString{"--socket-path=%1"}.arg(share.socket_path),
+            QString{"--shared-dir=%1"}.arg(QString::fromStdString(share.source)),
+            "--cache=auto",
+            "--announce-submounts",
+            QString{"--translate-uid=map:%1:%2:1"}.arg(instance_uid).arg(host_uid),
+            QString{"--translate-gid=map:%1:%2:1"}.arg(instance_gid).arg(host_gid)};
+}
+
+QString mp::VirtiofsdProcessSpec::apparmor_profile() const
+{
+    QString profile_template(R"END(
+#include <tunables/global>
+profile %1 flags=(attach_disconnected) {
+  #include <abstractions/base>
+
+  capability chown,
+  capability dac_override,
+  capability dac_read_search,
+  capability fowner,
+  capability fsetid,
+  capability mknod,
+  capability setfcap,
+  capability setgid,
+  capability setuid,
+  capability sys_admin,         # sandboxing in namespaces
+  capability sys_resource,      # raising the open files limit
+
+  mount,
+  umount,
+  pivot_root,
+
+  # Allow multipassd send virtiofsd signals
+  signal (receive) peer=%2,
+
+  @{PROC}/** r,
+  @{PROC}/@{pid}/{uid_map,gid_map,setgroups} rw,
+
+  # binary and its libs
+  %3 ixr,
+  %4/{usr/,}lib/@{multiarch}/{,**/}*.so* rm,
+
+  # CLASSIC ONLY: need to specify required libs from core snap
+  /{,var/lib/snapd/}snap/core*/*/{,usr/}lib/@{multiarch}/{,**/}*.so* rm,
+
+  %5{,.pid} rwk,    # vhost-user socket and its lock
+
+  %6/ r,
+  %6/** rwlk,
+}
+    )END");
+
+    const auto root_dir = snap_root_dir();
+    // if snap confined, specify only multipassd can kill virtiofsd
+    const QString signal_peer = root_dir.isEmpty() ? "unconfined" : "snap.multipass.multipassd";
+
+    return profile_template.arg(apparmor_profile_name(), signal_peer, program(), root_dir, share.socket_path,
+                                QString::fromStdString(share.source));
+}
+
+QString mp::VirtiofsdProcessSpec::identifier() const
+{
+    return QString::fromStdString(tag);
+}
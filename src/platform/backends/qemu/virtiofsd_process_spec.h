@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MULTIPASS_VIRTIOFSD_PROCESS_SPEC_H
+#define MULTIPASS_VIRTIOFSD_PROCESS_SPEC_H
+
+#include <multipass/process/process_spec.h>
+
+#include <string>
+#include <utility>
+
+namespace multipass
+{
+struct VirtiofsShare
+{
+    std::string source;
+    QString socket_path;
+    std::pair<int, int> uid_map; // host id => instance id, as for 9p mounts
+    std::pair<int, int> gid_map;
+};
+
+// Whether QEMU arguments for a native mount attach a virtiofs device, rather than a 9p one
+bool is_virtiofs_mount(const QStringList& mount_args);
+
+// Throws std::runtime_error, saying why, unless a virtiofsd that can map ids (1.11 or later) is installed
+void check_virtiofsd_usable();
+
+class VirtiofsdProcessSpec : public ProcessSpec
+{
+public:
+    VirtiofsdProcessSpec(const std::string& tag, const VirtiofsShare& share);
+
+    QString program() const override;
+    QStringList arguments() const override;
+    QString apparmor_profile() const override;
+    QString identifier() const override;
+
+private:
+    const std::string tag;
+    const VirtiofsShare share;
+};
+} // namespace multipass
+
+#endif // MULTIPASS_VIRTIOFSD_PROCESS_SPEC_H
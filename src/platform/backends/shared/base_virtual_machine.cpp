@@ -37,6 +37,7 @@
 
 #include <QDir>
 
+#include <algorithm>
 #include <chrono>
 #include <functional>
 #include <mutex>
@@ -55,6 +56,9 @@ constexpr auto snapshot_extension = "snapshot.json";
 constexpr auto head_filename = "snapshot-head";
 constexpr auto count_filename = "snapshot-count";
 constexpr auto yes_overwrite = true;
+constexpr auto cloud_init_finished_marker = "/var/lib/cloud/instance/boot-finished";
+constexpr auto cloud_init_wait_step = 4s; // short of the 5s that ssh_exec waits for an exit code
+constexpr auto max_ssh_sessions = 3;
 
 void assert_vm_stopped(St state)
 {
@@ -88,22 +92,22 @@ mp::utils::TimeoutAction log_and_retry(const ExceptionT& e,
     return mp::utils::TimeoutAction::retry;
 };
 
-std::optional<mp::SSHSession> wait_until_ssh_up_helper(mp::VirtualMachine* virtual_machine,
+std::unique_ptr<mp::SSHSession> wait_until_ssh_up_helper(mp::VirtualMachine* virtual_machine,
                                                        std::chrono::milliseconds timeout,
                                                        const mp::SSHKeyProvider& key_provider)
 {
     static constexpr auto wait_step = 1s;
     mpl::log(mpl::Level::debug, virtual_machine->vm_name, "Waiting for SSH to be up");
 
-    std::optional<mp::SSHSession> session = std::nullopt;
+    std::unique_ptr<mp::SSHSession> session = nullptr;
     auto action = [virtual_machine, &key_provider, &session] {
         virtual_machine->ensure_vm_is_running();
         try
         {
-            session.emplace(virtual_machine->ssh_hostname(wait_step),
-                            virtual_machine->ssh_port(),
-                            virtual_machine->ssh_username(),
-                            key_provider);
+            session = std::make_unique<mp::SSHSession>(virtual_machine->ssh_hostname(wait_step),
+                                                       virtual_machine->ssh_port(),
+                                                       virtual_machine->ssh_username(),
+                                                       key_provider);
 
             std::lock_guard<decltype(virtual_machine->state_mutex)> lock{virtual_machine->state_mutex};
             virtual_machine->state = mp::VirtualMachine::State::running;
@@ -166,6 +170,7 @@ void mp::BaseVirtualMachine::apply_extra_interfaces_and_instance_id_to_cloud_ini
     MP_CLOUD_INIT_FILE_OPS.update_cloud_init_with_new_extra_interfaces_and_new_id(default_mac_addr,
                                                                                   extra_interfaces,
                                                                                   new_instance_id,
+                                                                                  /* new_hostname = */ "",
                                                                                   cloud_init_config_iso_file_path);
 }
 
@@ -221,7 +226,14 @@ void mp::BaseVirtualMachine::check_state_for_shutdown(bool force)
 
 std::string mp::BaseVirtualMachine::ssh_exec(const std::string& cmd, bool whisper)
 {
-    std::unique_lock lock{state_mutex};
+    // Each command gets a session of its own; neither the state lock nor the pool's lock is held while it runs
+    auto checkout = checkout_ssh_session();
+    auto& ssh_session = checkout.first;
+    auto checkin_guard = sg::make_scope_guard([this, &checkout]() noexcept {
+        top_catch_all(vm_name, [this, &checkout] {
+            checkin_ssh_session(std::move(checkout.first), checkout.second);
+        });
+    });
 
     std::optional<std::string> log_details = std::nullopt;
     bool reconnect = true;
@@ -230,14 +242,16 @@ std::string mp::BaseVirtualMachine::ssh_exec(const std::string& cmd, bool whispe
         assert(reconnect && "we should have thrown otherwise");
         if ((!ssh_session || !ssh_session->is_connected()) && reconnect)
         {
-            const auto msg =
-                fmt::format("SSH session disconnected{}", log_details ? fmt::format(": {}", *log_details) : "");
-            mpl::log(logging::Level::info, vm_name, msg);
+            if (ssh_session || log_details) // otherwise, there was no idle session to reuse
+            {
+                const auto msg =
+                    fmt::format("SSH session disconnected{}", log_details ? fmt::format(": {}", *log_details) : "");
+                mpl::log(logging::Level::info, vm_name, msg);
+            }
 
             reconnect = false; // once only
-            lock.unlock();
-            renew_ssh_session();
-            lock.lock();
+            ssh_session.reset();
+            ssh_session = open_ssh_session();
         }
 
         try
@@ -258,7 +272,7 @@ std::string mp::BaseVirtualMachine::ssh_exec(const std::string& cmd, bool whispe
     assert(false && "we should never reach here");
 }
 
-void mp::BaseVirtualMachine::renew_ssh_session()
+std::unique_ptr<mp::SSHSession> mp::BaseVirtualMachine::open_ssh_session()
 {
     {
         const std::unique_lock lock{state_mutex};
@@ -266,27 +280,95 @@ void mp::BaseVirtualMachine::renew_ssh_session()
             throw SSHException{fmt::format("SSH unavailable on instance {}: not running", vm_name)};
     }
 
-    mpl::log(logging::Level::debug,
-             vm_name,
-             fmt::format("{} SSH session", ssh_session ? "Renewing cached" : "Caching new"));
+    mpl::log(logging::Level::debug, vm_name, "Opening new SSH session");
+
+    return std::make_unique<SSHSession>(ssh_hostname(), ssh_port(), ssh_username(), key_provider);
+}
+
+void mp::BaseVirtualMachine::renew_ssh_session()
+{
+    auto [ssh_session, generation] = checkout_ssh_session();
+    ssh_session.reset(); // disconnect the replaced session before opening another one
+
+    std::unique_ptr<SSHSession> new_session;
+    try
+    {
+        new_session = open_ssh_session();
+    }
+    catch (...)
+    {
+        checkin_ssh_session(nullptr, generation);
+        throw;
+    }
+
+    checkin_ssh_session(std::move(new_session), generation);
+}
+
+std::pair<std::unique_ptr<mp::SSHSession>, int> mp::BaseVirtualMachine::checkout_ssh_session()
+{
+    std::unique_lock lock{ssh_mutex};
+    ssh_session_available.wait(lock, [this] {
+        return !idle_ssh_sessions.empty() || busy_ssh_sessions < max_ssh_sessions;
+    });
+
+    ++busy_ssh_sessions;
+    if (idle_ssh_sessions.empty())
+        return {nullptr, ssh_sessions_generation}; // the caller is to open a new one
 
-    ssh_session.emplace(ssh_hostname(), ssh_port(), ssh_username(), key_provider);
+    auto session = std::move(idle_ssh_sessions.back());
+    idle_ssh_sessions.pop_back();
+
+    return {std::move(session), ssh_sessions_generation};
+}
+
+void mp::BaseVirtualMachine::checkin_ssh_session(std::unique_ptr<SSHSession> session, int generation)
+{
+    // sessions that were dropped or disconnected while in use are closed here, outside the lock
+    const auto keep = session && session->is_connected();
+
+    {
+        const std::lock_guard lock{ssh_mutex};
+        --busy_ssh_sessions;
+        if (keep && generation == ssh_sessions_generation)
+            idle_ssh_sessions.push_back(std::move(session));
+    }
+
+    ssh_session_available.notify_one();
 }
 
 void mp::BaseVirtualMachine::wait_until_ssh_up(std::chrono::milliseconds timeout)
 {
     drop_ssh_session();
-    ssh_session = wait_until_ssh_up_helper(this, timeout, key_provider);
+
+    auto [ssh_session, generation] = checkout_ssh_session();
+    try
+    {
+        ssh_session = wait_until_ssh_up_helper(this, timeout, key_provider);
+    }
+    catch (...)
+    {
+        checkin_ssh_session(nullptr, generation);
+        throw;
+    }
+
     mpl::log(logging::Level::debug, vm_name, "Caching initial SSH session");
+    checkin_ssh_session(std::move(ssh_session), generation);
 }
 
 void mp::BaseVirtualMachine::wait_for_cloud_init(std::chrono::milliseconds timeout)
 {
-    auto action = [this] {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    auto action = [this, &deadline] {
         ensure_vm_is_running();
         try
         {
-            ssh_exec("[ -e /var/lib/cloud/instance/boot-finished ]");
+            // Wait on the guest side, to notice completion right away without a new command for each check. The wait is
+            // done in bounded steps, so as to not hog the SSH session for too long.
+            const auto remaining = std::chrono::ceil<std::chrono::seconds>(deadline - std::chrono::steady_clock::now());
+            const auto step = std::clamp(remaining, std::chrono::seconds{1}, cloud_init_wait_step);
+            ssh_exec(fmt::format("timeout {} sh -c 'until [ -e {} ]; do sleep 0.1; done'",
+                                 step.count(),
+                                 cloud_init_finished_marker));
             return mp::utils::TimeoutAction::done;
         }
         catch (const SSHExecFailure& e)
@@ -795,9 +877,13 @@ std::shared_ptr<mp::Snapshot> mp::BaseVirtualMachine::make_specific_snapshot(con
 
 void mp::BaseVirtualMachine::drop_ssh_session()
 {
-    if (ssh_session)
+    std::vector<std::unique_ptr<SSHSession>> dropped;
     {
-        mpl::log(mpl::Level::debug, vm_name, "Dropping cached SSH session");
-        ssh_session.reset();
+        const std::lock_guard lock{ssh_mutex};
+        ++ssh_sessions_generation;
+        dropped.swap(idle_ssh_sessions);
     }
+
+    if (!dropped.empty())
+        mpl::log(mpl::Level::debug, vm_name, fmt::format("Dropping {} cached SSH session(s)", dropped.size()));
 }
@@ -29,10 +29,13 @@
 #include <QRegularExpression>
 #include <QString>
 
+#include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace multipass
 {
@@ -64,6 +67,14 @@ public:
     {
         throw NotImplementedOnThisBackendException("native mounts");
     };
+    void update_disk_profile(const std::string& profile) override
+    {
+        throw NotImplementedOnThisBackendException("disk profiles");
+    }
+    void update_memory_profile(const std::string& profile) override
+    {
+        throw NotImplementedOnThisBackendException("memory profiles");
+    }
 
     SnapshotVista view_snapshots() const override;
     int get_num_snapshots() const override;
@@ -95,6 +106,7 @@ protected:
                                                              std::shared_ptr<Snapshot> parent);
     virtual void drop_ssh_session(); // virtual to allow mocking
     void renew_ssh_session();
+    std::unique_ptr<SSHSession> open_ssh_session();
 
     virtual void add_extra_interface_to_instance_cloud_init(const std::string& default_mac_addr,
                                                             const NetworkInterface& extra_interface) const;
@@ -149,11 +161,19 @@ private:
 
     void delete_snapshot_helper(std::shared_ptr<Snapshot>& snapshot);
 
+    std::pair<std::unique_ptr<SSHSession>, int> checkout_ssh_session();
+    void checkin_ssh_session(std::unique_ptr<SSHSession> session, int generation);
+
 protected:
     const SSHKeyProvider& key_provider;
 
 private:
-    std::optional<SSHSession> ssh_session = std::nullopt;
+    // Small pool of SSH sessions, so that concurrent commands on the same instance don't wait for each other
+    std::vector<std::unique_ptr<SSHSession>> idle_ssh_sessions;
+    int busy_ssh_sessions = 0;
+    int ssh_sessions_generation = 0; // bumped when sessions are dropped, so that busy ones aren't reused
+    std::mutex ssh_mutex;
+    std::condition_variable ssh_session_available;
     SnapshotMap snapshots;
     std::shared_ptr<Snapshot> head_snapshot = nullptr;
     int snapshot_count = 0; // tracks the number of snapshots ever taken (regardless or deletes)
@@ -51,6 +51,25 @@ void mp::BaseVirtualMachineFactory::configure(VirtualMachineDescription& vm_desc
     vm_desc.cloud_init_iso = cloud_init_iso;
 }
 
+void mp::BaseVirtualMachineFactory::prepare_clone(const std::string& source_name, VirtualMachineDescription& vm_desc)
+{
+    const auto source_iso = QDir{get_instance_directory(source_name)}.filePath("cloud-init-config.iso");
+    const auto cloud_init_iso = mpu::base_dir(vm_desc.image.image_path).filePath("cloud-init-config.iso");
+
+    QFile::remove(cloud_init_iso);
+    if (!QFile::copy(source_iso, cloud_init_iso))
+        throw std::runtime_error(fmt::format("Could not copy {} to {}", source_iso, cloud_init_iso));
+
+    // A new instance id has cloud-init treat the clone as a new instance on its first boot
+    MP_CLOUD_INIT_FILE_OPS.update_cloud_init_with_new_extra_interfaces_and_new_id(vm_desc.default_mac_address,
+                                                                                  vm_desc.extra_interfaces,
+                                                                                  vm_desc.vm_name,
+                                                                                  vm_desc.vm_name,
+                                                                                  cloud_init_iso.toStdString());
+
+    vm_desc.cloud_init_iso = cloud_init_iso;
+}
+
 void mp::BaseVirtualMachineFactory::prepare_networking(std::vector<NetworkInterface>& extra_interfaces)
 {
     if (!extra_interfaces.empty())
@@ -18,10 +18,12 @@
 #ifndef MULTIPASS_BASE_VIRTUAL_MACHINE_FACTORY_H
 #define MULTIPASS_BASE_VIRTUAL_MACHINE_FACTORY_H
 
+#include <multipass/constants.h>
 #include <multipass/exceptions/not_implemented_on_this_backend_exception.h>
 #include <multipass/format.h>
 #include <multipass/logging/log.h>
 #include <multipass/mount_handler.h>
+#include <multipass/settings/settings.h>
 #include <multipass/utils.h>
 #include <multipass/virtual_machine_factory.h>
 
@@ -60,11 +62,13 @@ public:
                                           const days& days_to_expire) override
     {
         return std::make_unique<DefaultVMImageVault>(image_hosts, downloader, cache_dir_path, data_dir_path,
-                                                     days_to_expire);
+                                                     days_to_expire, MP_SETTINGS.get_as<int>(image_pool_key));
     };
 
     void configure(VirtualMachineDescription& vm_desc) override;
 
+    void prepare_clone(const std::string& source_name, VirtualMachineDescription& vm_desc) override;
+
     std::vector<NetworkInterfaceInfo> networks() const override
     {
         throw NotImplementedOnThisBackendException("networks");
@@ -74,6 +78,11 @@ public:
 
     void require_suspend_support() const override;
 
+    bool supports_concurrent_vm_creation() const override
+    {
+        return false;
+    };
+
 protected:
     static const Path instances_subdir;
 
@@ -23,22 +23,102 @@
 #include <multipass/platform.h>
 #include <multipass/process/qemuimg_process_spec.h>
 
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QRegularExpression>
 #include <QString>
 #include <QStringList>
 
+#include <map>
+#include <mutex>
+
 namespace mp = multipass;
 namespace mpp = multipass::platform;
 
+namespace
+{
+constexpr quint32 qcow2_magic = 0x514649fb; // "QFI\xfb"
+constexpr quint32 qcow2_max_snapshots = 65536; // QEMU's own limits, used to reject corrupt tables
+constexpr quint32 qcow2_max_snapshot_extra_data = 1024;
+
+struct CachedQcow2Info
+{
+    qint64 size;
+    QDateTime last_modified;
+    mp::backend::Qcow2Info info;
+};
+
+std::mutex qcow2_info_cache_mutex;
+std::map<QString, CachedQcow2Info> qcow2_info_cache;
+
+void forget_qcow2_info(const QString& image_path)
+{
+    std::lock_guard lock{qcow2_info_cache_mutex};
+    qcow2_info_cache.erase(image_path);
+}
+
+// see docs/interop/qcow2.txt in the QEMU sources for the layout
+std::optional<mp::backend::Qcow2Info> parse_qcow2_info(QFile& file)
+{
+    QDataStream stream{&file}; // QCOW2 fields are big-endian, which is QDataStream's default
+
+    quint32 magic, version, nb_snapshots;
+    quint64 snapshots_offset;
+    stream >> magic >> version;
+    stream.skipRawData(52); // backing file, cluster bits, size, encryption, L1 and refcount tables
+    stream >> nb_snapshots >> snapshots_offset;
+
+    if (stream.status() != QDataStream::Ok || magic != qcow2_magic || version < 2 || version > 3 ||
+        nb_snapshots > qcow2_max_snapshots || (nb_snapshots && !file.seek(snapshots_offset)))
+        return std::nullopt;
+
+    mp::backend::Qcow2Info info{static_cast<int>(version), {}};
+    for (quint32 i = 0; i < nb_snapshots; ++i)
+    {
+        quint16 id_size, name_size;
+        quint32 extra_data_size;
+
+        stream.skipRawData(12); // L1 table offset and size
+        stream >> id_size >> name_size;
+        stream.skipRawData(20); // dates, VM clock and VM state size
+        stream >> extra_data_size;
+
+        if (stream.status() != QDataStream::Ok || extra_data_size > qcow2_max_snapshot_extra_data)
+            return std::nullopt;
+
+        QByteArray name(name_size, Qt::Uninitialized);
+        stream.skipRawData(extra_data_size + id_size);
+        stream.readRawData(name.data(), name_size);
+
+        const auto entry_size = 40 + extra_data_size + id_size + name_size;
+        stream.skipRawData((8 - entry_size % 8) % 8); // entries are 8-byte aligned
+
+        if (stream.status() != QDataStream::Ok)
+            return std::nullopt;
+
+        info.snapshot_tags.append(QString::fromUtf8(name));
+    }
+
+    return info;
+}
+} // namespace
+
 auto mp::backend::checked_exec_qemu_img(std::unique_ptr<mp::QemuImgProcessSpec> spec,
                                         const std::string& custom_error_prefix,
                                         std::optional<int> timeout) -> Process::UPtr
 {
+    const auto args = spec->arguments();
     auto process = mpp::make_process(std::move(spec));
 
     auto process_state = timeout ? process->execute(*timeout) : process->execute();
+
+    for (const auto& arg : args) // whatever images qemu-img was given may have changed
+        forget_qcow2_info(arg);
+
     if (!process_state.completed_successfully())
     {
         throw QemuImgException{fmt::format("{}: qemu-img failed ({}) with output:\n{}",
@@ -89,6 +169,9 @@ mp::Path mp::backend::convert_to_qcow_if_necessary(const mp::Path& image_path)
 
 void mp::backend::amend_to_qcow2_v3(const mp::Path& image_path)
 {
+    if (const auto info = read_qcow2_info(image_path); info && info->version >= 3)
+        return;
+
     checked_exec_qemu_img(
         std::make_unique<mp::QemuImgProcessSpec>(QStringList{"amend", "-o", "compat=1.1", image_path}, image_path),
         "Failed to amend image to QCOW2 v3");
@@ -96,6 +179,9 @@ void mp::backend::amend_to_qcow2_v3(const mp::Path& image_path)
 
 bool mp::backend::instance_image_has_snapshot(const mp::Path& image_path, QString snapshot_tag)
 {
+    if (const auto info = read_qcow2_info(image_path))
+        return info->snapshot_tags.contains(snapshot_tag);
+
     auto process = checked_exec_qemu_img(
         std::make_unique<mp::QemuImgProcessSpec>(QStringList{"snapshot", "-l", image_path}, image_path));
 
@@ -109,3 +195,28 @@ void mp::backend::delete_instance_suspend_image(const Path& image_path, const QS
         std::make_unique<mp::QemuImgProcessSpec>(QStringList{"snapshot", "-d", suspend_tag, image_path}, image_path),
         "Failed to delete suspend image");
 }
+
+auto mp::backend::read_qcow2_info(const Path& image_path) -> std::optional<Qcow2Info>
+{
+    const QFileInfo file_info{image_path};
+
+    std::lock_guard lock{qcow2_info_cache_mutex};
+    if (auto it = qcow2_info_cache.find(image_path); it != qcow2_info_cache.end())
+    {
+        const auto& cached = it->second;
+        if (cached.size == file_info.size() && cached.last_modified == file_info.lastModified())
+            return cached.info;
+
+        qcow2_info_cache.erase(it);
+    }
+
+    QFile file{image_path};
+    if (!file.open(QIODevice::ReadOnly))
+        return std::nullopt;
+
+    auto info = parse_qcow2_info(file);
+    if (info)
+        qcow2_info_cache[image_path] = {file_info.size(), file_info.lastModified(), *info};
+
+    return info;
+}
@@ -21,6 +21,8 @@
 #include <multipass/path.h>
 #include <multipass/platform.h>
 
+#include <QStringList>
+
 #include <optional>
 
 namespace multipass
@@ -36,6 +38,12 @@ public:
     using std::runtime_error::runtime_error;
 };
 
+struct Qcow2Info
+{
+    int version;
+    QStringList snapshot_tags;
+};
+
 Process::UPtr checked_exec_qemu_img(std::unique_ptr<QemuImgProcessSpec> spec,
                                     const std::string& custom_error_prefix = "Internal error",
                                     std::optional<int> timeout = std::nullopt);
@@ -45,6 +53,11 @@ void amend_to_qcow2_v3(const Path& image_path);
 bool instance_image_has_snapshot(const Path& image_path, QString snapshot_tag);
 void delete_instance_suspend_image(const Path& image_path, const QString& suspend_tag);
 
+// Read the header and snapshot table of a QCOW2 image without spawning qemu-img. Results are cached until the file
+// changes or qemu-img is run on it. Returns nullopt when the image can't be read as QCOW2 v2/v3, so that callers can
+// defer to qemu-img.
+std::optional<Qcow2Info> read_qcow2_info(const Path& image_path);
+
 } // namespace backend
 } // namespace multipass
 #endif // MULTIPASS_QEMU_IMG_UTILS_H
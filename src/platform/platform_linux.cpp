@@ -420,7 +420,11 @@ mp::VirtualMachineFactory::UPtr mp::platform::vm_backend(const mp::Path& data_di
     const auto& driver = MP_SETTINGS.get(mp::driver_key);
 #if QEMU_ENABLED
     if (driver == QStringLiteral("qemu"))
-        return std::make_unique<QemuVirtualMachineFactory>(data_dir);
+        return std::make_unique<QemuVirtualMachineFactory>(
+            data_dir,
+            MP_SETTINGS.get(mp::qemu_suspend_mode_key) == QStringLiteral("file"),
+            MP_SETTINGS.get(mp::qemu_mount_driver_key) == QStringLiteral("virtiofs"),
+            MP_SETTINGS.get(mp::qemu_overcommit_key) == QStringLiteral("psi"));
 #endif
 
     if (driver == QStringLiteral("libvirt"))
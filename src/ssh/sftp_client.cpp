@@ -24,12 +24,13 @@
 #include <multipass/ssh/throw_on_error.h>
 #include <multipass/utils.h>
 
-#include <array>
 #include <fcntl.h>
 #include <fmt/std.h>
+#include <vector>
 
 constexpr int file_mode = 0664;
 constexpr auto max_transfer = 65536u;
+constexpr auto max_bulk_transfer = 131072u; // keeps requests well within the 256KiB sftp-server message limit
 const std::string stream_file_name{"stream_output.dat"};
 const char* log_category = "sftp";
 
@@ -37,6 +38,15 @@ namespace multipass
 {
 namespace mpl = logging;
 
+namespace
+{
+std::vector<char> make_transfer_buffer()
+{
+    return std::vector<char>(SSHSession::transport_profile() == SSHTransportProfile::bulk ? max_bulk_transfer
+                                                                                           : max_transfer);
+}
+} // namespace
+
 SFTPSessionUPtr make_sftp_session(ssh_session session)
 {
     auto sftp = mp_sftp_new(session);
@@ -331,7 +341,7 @@ void SFTPClient::do_push_file(std::istream& source, const fs::path& target_path)
     if (!remote_file)
         throw SFTPError{"cannot open remote file {}: {}", target_path, ssh_get_error(sftp->session)};
 
-    std::array<char, max_transfer> buffer{};
+    auto buffer = make_transfer_buffer();
     while (auto r = source.read(buffer.data(), buffer.size()).gcount())
         if (sftp_write(remote_file.get(), buffer.data(), r) < 0)
             throw SFTPError{"cannot write to remote file {}: {}", target_path, ssh_get_error(sftp->session)};
@@ -343,7 +353,7 @@ void SFTPClient::do_pull_file(const fs::path& source_path, std::ostream& target)
     if (!remote_file)
         throw SFTPError{"cannot open remote file {}: {}", source_path, ssh_get_error(sftp->session)};
 
-    std::array<char, max_transfer> buffer{};
+    auto buffer = make_transfer_buffer();
     while (auto r = sftp_read(remote_file.get(), buffer.data(), buffer.size()))
     {
         if (r < 0)
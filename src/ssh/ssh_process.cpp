@@ -27,7 +27,7 @@
 #include <array>
 #include <cerrno>
 #include <cstring>
-#include <sstream>
+#include <utility>
 
 namespace mp = multipass;
 namespace mpl = multipass::logging;
@@ -36,18 +36,26 @@ namespace
 {
 constexpr auto category = "ssh process";
 
-template <typename T>
-class ExitStatusCallback
+constexpr auto read_chunk_size = 16384u;
+
+// Collects the exit status and, optionally, any output that arrives while waiting for it, as the session signals
+// readiness. Draining output keeps the channel window open, so that chatty processes do not stall before reporting
+// their exit.
+template <typename T, typename Buffers>
+class ChannelCallbacks
 {
 public:
-    ExitStatusCallback(ssh_channel channel, T& result_holder) : channel{channel}
+    ChannelCallbacks(ssh_channel channel, T& result_holder, Buffers* output)
+        : channel{channel}, result_holder{result_holder}, output{output}
     {
         ssh_callbacks_init(&cb);
         cb.channel_exit_status_function = channel_exit_status_cb;
-        cb.userdata = &result_holder;
+        if (output)
+            cb.channel_data_function = channel_data_cb;
+        cb.userdata = this;
         ssh_add_channel_callbacks(channel, &cb);
     }
-    ~ExitStatusCallback()
+    ~ChannelCallbacks()
     {
         ssh_remove_channel_callbacks(channel, &cb);
     }
@@ -55,10 +63,17 @@ public:
 private:
     static void channel_exit_status_cb(ssh_session, ssh_channel, int exit_status, void* userdata)
     {
-        auto exit_code = reinterpret_cast<T*>(userdata);
-        *exit_code = exit_status;
+        reinterpret_cast<ChannelCallbacks*>(userdata)->result_holder = exit_status;
+    }
+    static int channel_data_cb(ssh_session, ssh_channel, void* data, uint32_t len, int is_stderr, void* userdata)
+    {
+        auto& buffer = (*reinterpret_cast<ChannelCallbacks*>(userdata)->output)[is_stderr ? 1 : 0];
+        buffer.append(static_cast<const char*>(data), len);
+        return static_cast<int>(len);
     }
     ssh_channel channel;
+    T& result_holder;
+    Buffers* output;
     ssh_channel_callbacks_struct cb{};
 };
 
@@ -94,7 +109,7 @@ bool mp::SSHProcess::exit_recognized(std::chrono::milliseconds timeout)
 
     try
     {
-        read_exit_code(timeout, /* save_exception = */ false);
+        read_exit_code(timeout, /* save_exception = */ false, /* drain_output = */ false);
         return true;
     }
     catch (SSHProcessTimeoutException&)
@@ -110,26 +125,57 @@ int mp::SSHProcess::exit_code(std::chrono::milliseconds timeout)
         return *exit_status;
 
     auto local_lock = std::move(session_lock); // unlock at the end
-    read_exit_code(timeout, /* save_exception = */ true);
+    read_exit_code(timeout, /* save_exception = */ true, /* drain_output = */ true);
 
     assert(std::holds_alternative<int>(exit_result));
     return std::get<int>(exit_result);
 }
 
-void mp::SSHProcess::read_exit_code(std::chrono::milliseconds timeout, bool save_exception)
+bool mp::SSHProcess::wait_for_output(std::chrono::milliseconds timeout, std::string& std_out, std::string& std_err)
 {
-    assert(std::holds_alternative<std::monostate>(exit_result));
-    ExitStatusCallback cb{channel.get(), exit_result};
+    rethrow_if_saved();
+    if (!std::holds_alternative<int>(exit_result))
+    {
+        try
+        {
+            read_exit_code(timeout, /* save_exception = */ false, /* drain_output = */ true);
+        }
+        catch (SSHProcessTimeoutException&)
+        {
+        }
+    }
 
+    std_out = std::exchange(buffered_output[0], {});
+    std_err = std::exchange(buffered_output[1], {});
+
+    return std::holds_alternative<int>(exit_result);
+}
+
+void mp::SSHProcess::send_signal(const std::string& signal)
+{
+    SSH::throw_on_error(channel, session, "[ssh proc] failed to send signal", ssh_channel_request_send_signal,
+                        signal.c_str());
+}
+
+void mp::SSHProcess::read_exit_code(std::chrono::milliseconds timeout, bool save_exception, bool drain_output)
+{
+    assert(std::holds_alternative<std::monostate>(exit_result));
+    // Only drain output when asked to. Processes that are merely probed may still have their channel handed over (see
+    // SftpServer), in which case their output must stay in the channel.
+    ChannelCallbacks cb{channel.get(), exit_result, drain_output ? &buffered_output : nullptr};
     std::unique_ptr<ssh_event_struct, decltype(ssh_event_free)*> event{ssh_event_new(), ssh_event_free};
     ssh_event_add_session(event.get(), session);
 
-    auto deadline = std::chrono::steady_clock::now() + timeout;
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
 
     int rc{SSH_OK};
-    while ((std::chrono::steady_clock::now() < deadline) && rc == SSH_OK && !std::holds_alternative<int>(exit_result))
+    for (auto now = std::chrono::steady_clock::now();
+         now < deadline && rc == SSH_OK && !std::holds_alternative<int>(exit_result);
+         now = std::chrono::steady_clock::now())
     {
-        rc = ssh_event_dopoll(event.get(), timeout.count());
+        // wake up on whatever arrives first, but never wait past the overall deadline
+        const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - now);
+        rc = ssh_event_dopoll(event.get(), static_cast<int>(remaining.count()));
     }
 
     if (!std::holds_alternative<int>(exit_result))
@@ -168,19 +214,21 @@ std::string mp::SSHProcess::read_stream(StreamType type, int timeout)
                          __FUNCTION__,
                          static_cast<int>(type),
                          timeout));
-    // If the channel is closed there's no output to read
+    // Start with whatever arrived while waiting for the exit code
+    const bool is_std_err = type == StreamType::err;
+    auto output = std::exchange(buffered_output[is_std_err ? 1 : 0], {});
+
+    // If the channel is closed there's no more output to read
     if (ssh_channel_is_closed(channel.get()))
     {
         mpl::log(mpl::Level::trace,
                  category,
                  fmt::format("{}:{} {}(): channel closed", __FILE__, __LINE__, __FUNCTION__));
-        return std::string();
+        return output;
     }
 
-    std::stringstream output;
-    std::array<char, 256> buffer;
+    std::array<char, read_chunk_size> buffer;
     int num_bytes{0};
-    const bool is_std_err = type == StreamType::err;
     do
     {
         num_bytes = ssh_channel_read_timeout(channel.get(), buffer.data(), buffer.size(), is_std_err, timeout);
@@ -195,16 +243,16 @@ std::string mp::SSHProcess::read_stream(StreamType type, int timeout)
                 mpl::log(mpl::Level::trace,
                          category,
                          fmt::format("{}:{} {}(): channel closed", __FILE__, __LINE__, __FUNCTION__));
-                return output.str();
+                return output;
             }
 
             throw mp::SSHException(
                 fmt::format("error while reading ssh channel for remote process '{}' - error: {}", cmd, num_bytes));
         }
-        output.write(buffer.data(), num_bytes);
+        output.append(buffer.data(), num_bytes);
     } while (num_bytes > 0);
 
-    return output.str();
+    return output;
 }
 
 ssh_channel mp::SSHProcess::release_channel()
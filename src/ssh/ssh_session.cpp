@@ -25,11 +25,73 @@
 
 #include <QDir>
 
+#include <atomic>
 #include <string>
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__aarch64__) && defined(__linux__)
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
 namespace mp = multipass;
 namespace mpl = multipass::logging;
 
+namespace
+{
+std::atomic<mp::SSHTransportProfile> current_transport_profile{mp::SSHTransportProfile::standard};
+
+bool host_has_aes_instructions()
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4];
+    __cpuid(info, 1);
+    return info[2] & (1 << 25);
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("aes");
+#elif defined(__aarch64__) && defined(__APPLE__)
+    return true;
+#elif defined(__aarch64__) && defined(__linux__)
+    return getauxval(AT_HWCAP) & HWCAP_AES;
+#else
+    return false;
+#endif
+}
+
+// AES-GCM is the fastest option with hardware support, chacha20-poly1305 is the fastest without it
+const char* preferred_ciphers()
+{
+    static const auto ciphers =
+        host_has_aes_instructions()
+            ? "aes128-gcm@openssh.com,aes256-gcm@openssh.com,chacha20-poly1305@openssh.com,aes256-ctr"
+            : "chacha20-poly1305@openssh.com,aes128-gcm@openssh.com,aes256-gcm@openssh.com,aes256-ctr";
+    return ciphers;
+}
+} // namespace
+
+std::optional<mp::SSHTransportProfile> mp::ssh_transport_profile_from(const std::string& name)
+{
+    if (name == "default")
+        return SSHTransportProfile::standard;
+    if (name == "bulk")
+        return SSHTransportProfile::bulk;
+
+    return std::nullopt;
+}
+
+std::string mp::ssh_transport_profile_name(SSHTransportProfile profile)
+{
+    switch (profile)
+    {
+    case SSHTransportProfile::bulk:
+        return "bulk";
+    default:
+        return "default";
+    }
+}
+
 mp::SSHSession::SSHSession(const std::string& host,
                            int port,
                            const std::string& username,
@@ -49,8 +111,8 @@ mp::SSHSession::SSHSession(const std::string& host,
     set_option(SSH_OPTIONS_USER, username.c_str());
     set_option(SSH_OPTIONS_TIMEOUT, &timeout_secs);
     set_option(SSH_OPTIONS_NODELAY, &nodelay);
-    set_option(SSH_OPTIONS_CIPHERS_C_S, "chacha20-poly1305@openssh.com,aes256-ctr");
-    set_option(SSH_OPTIONS_CIPHERS_S_C, "chacha20-poly1305@openssh.com,aes256-ctr");
+    set_option(SSH_OPTIONS_CIPHERS_C_S, preferred_ciphers());
+    set_option(SSH_OPTIONS_CIPHERS_S_C, preferred_ciphers());
     set_option(SSH_OPTIONS_SSH_DIR, ssh_dir.c_str());
 
     SSH::throw_on_error(session, "ssh connection failed", ssh_connect);
@@ -111,6 +173,16 @@ mp::SSHSession::operator ssh_session()
     return session.get();
 }
 
+void mp::SSHSession::set_transport_profile(SSHTransportProfile profile)
+{
+    current_transport_profile = profile;
+}
+
+mp::SSHTransportProfile mp::SSHSession::transport_profile()
+{
+    return current_transport_profile;
+}
+
 namespace
 {
 const char* name_for(ssh_options_e type)
@@ -1031,6 +1031,14 @@ TEST_F(LXDBackend, factoryDoesNotSupportSuspend)
                          mpt::match_what(HasSubstr("suspend")));
 }
 
+TEST_F(LXDBackend, factoryDoesNotSupportClones)
+{
+    mp::LXDVirtualMachineFactory backend{std::move(mock_network_access_manager), data_dir.path(), base_url};
+    MP_EXPECT_THROW_THAT(backend.prepare_clone("pied-piper-valley", default_description),
+                         mp::NotImplementedOnThisBackendException,
+                         mpt::match_what(HasSubstr("clone")));
+}
+
 TEST_F(LXDBackend, image_fetch_type_returns_expected_type)
 {
     mp::LXDVirtualMachineFactory backend{std::move(mock_network_access_manager), data_dir.path(), base_url};
@@ -32,6 +32,7 @@
 #include <multipass/exceptions/aborted_download_exception.h>
 #include <multipass/exceptions/image_vault_exceptions.h>
 #include <multipass/exceptions/local_socket_connection_exception.h>
+#include <multipass/exceptions/not_implemented_on_this_backend_exception.h>
 #include <multipass/format.h>
 #include <multipass/vm_image.h>
 
@@ -561,6 +562,15 @@ TEST_F(LXDImageVault, delete_requested_on_instance_remove)
     EXPECT_TRUE(wait_requested);
 }
 
+TEST_F(LXDImageVault, clone_is_not_implemented)
+{
+    mp::LXDVMImageVault image_vault{hosts,    &stub_url_downloader, mock_network_access_manager.get(),
+                                    base_url, cache_dir.path(),     mp::days{0}};
+
+    EXPECT_THROW(image_vault.clone(instance_name, "dolores", save_dir.path()),
+                 mp::NotImplementedOnThisBackendException);
+}
+
 TEST_F(LXDImageVault, logs_warning_when_removing_nonexistent_instance)
 {
     ON_CALL(*mock_network_access_manager.get(), createRequest(_, _, _)).WillByDefault([](auto, auto request, auto) {
@@ -68,6 +68,10 @@ struct MockDaemon : public Daemon
                 (const SSHInfoRequest*, (grpc::ServerReaderWriterInterface<SSHInfoReply, SSHInfoRequest>*),
                  std::promise<grpc::Status>*),
                 (override));
+    MOCK_METHOD(void, exec,
+                (const ExecRequest*, (grpc::ServerReaderWriterInterface<ExecReply, ExecRequest>*),
+                 std::promise<grpc::Status>*, std::function<bool()>),
+                (override));
     MOCK_METHOD(void, start,
                 (const StartRequest*, (grpc::ServerReaderWriterInterface<StartReply, StartRequest>*),
                  std::promise<grpc::Status>*),
@@ -129,6 +133,12 @@ struct MockDaemon : public Daemon
                  (grpc::ServerReaderWriterInterface<RestoreReply, RestoreRequest>*),
                  std::promise<grpc::Status>*),
                 (override));
+    MOCK_METHOD(void,
+                clone,
+                (const CloneRequest*,
+                 (grpc::ServerReaderWriterInterface<CloneReply, CloneRequest>*),
+                 std::promise<grpc::Status>*),
+                (override));
 
     template <typename Request, typename Reply>
     void set_promise_value(const Request*, grpc::ServerReaderWriterInterface<Reply, Request>*,
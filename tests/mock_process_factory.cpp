@@ -48,6 +48,7 @@ mpt::MockProcess::MockProcess(std::unique_ptr<mp::ProcessSpec>&& spec,
     ON_CALL(*this, process_state()).WillByDefault(Return(success_exit_state));
     ON_CALL(*this, execute(_)).WillByDefault(Return(success_exit_state));
     ON_CALL(*this, wait_for_started(_)).WillByDefault(Return(true));
+    ON_CALL(*this, wait_for_ready_read(_)).WillByDefault(Return(true));
 
     mpt::MockProcessFactory::ProcessInfo p{program(), arguments()};
     process_list.emplace_back(p);
@@ -111,11 +112,6 @@ QProcessEnvironment mpt::MockProcess::process_environment() const
     return spec->environment();
 }
 
-bool mpt::MockProcess::wait_for_ready_read(int)
-{
-    return true;
-}
-
 void mpt::MockProcess::close_write_channel()
 {
 }
@@ -29,6 +29,7 @@ extern "C"
     IMPL_MOCK_DEFAULT(1, ssh_channel_new);
     IMPL_MOCK_DEFAULT(1, ssh_channel_open_session);
     IMPL_MOCK_DEFAULT(2, ssh_channel_request_exec);
+    IMPL_MOCK_DEFAULT(2, ssh_channel_request_send_signal);
     IMPL_MOCK_DEFAULT(5, ssh_channel_read_timeout);
     IMPL_MOCK_DEFAULT(1, ssh_channel_get_exit_status);
     IMPL_MOCK_DEFAULT(2, ssh_event_dopoll);
@@ -34,6 +34,7 @@ DECL_MOCK(ssh_channel_is_open);
 DECL_MOCK(ssh_channel_new);
 DECL_MOCK(ssh_channel_open_session);
 DECL_MOCK(ssh_channel_request_exec);
+DECL_MOCK(ssh_channel_request_send_signal);
 DECL_MOCK(ssh_channel_read_timeout);
 DECL_MOCK(ssh_channel_get_exit_status);
 DECL_MOCK(ssh_event_dopoll);
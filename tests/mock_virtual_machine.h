@@ -80,6 +80,8 @@ struct MockVirtualMachineT : public T
     MOCK_METHOD(void, update_cpus, (int), (override));
     MOCK_METHOD(void, resize_memory, (const MemorySize&), (override));
     MOCK_METHOD(void, resize_disk, (const MemorySize&), (override));
+    MOCK_METHOD(void, update_disk_profile, (const std::string&), (override));
+    MOCK_METHOD(void, update_memory_profile, (const std::string&), (override));
     MOCK_METHOD(void, add_network_interface, (int, const std::string&, const NetworkInterface&), (override));
     MOCK_METHOD(std::unique_ptr<MountHandler>,
                 make_native_mount_handler,
@@ -48,9 +48,11 @@ struct MockVirtualMachineFactory : public VirtualMachineFactory
     MOCK_METHOD(VMImageVault::UPtr, create_image_vault,
                 (std::vector<VMImageHost*>, URLDownloader*, const Path&, const Path&, const days&), (override));
     MOCK_METHOD(void, configure, (VirtualMachineDescription&), (override));
+    MOCK_METHOD(void, prepare_clone, (const std::string&, VirtualMachineDescription&), (override));
     MOCK_METHOD(std::vector<NetworkInterfaceInfo>, networks, (), (const, override));
     MOCK_METHOD(void, require_snapshots_support, (), (const, override));
     MOCK_METHOD(void, require_suspend_support, (), (const, override));
+    MOCK_METHOD(bool, supports_concurrent_vm_creation, (), (const, override));
 
     // originally protected:
     MOCK_METHOD(std::string, create_bridge_with, (const NetworkInterfaceInfo&), (override));
@@ -54,6 +54,7 @@ public:
                  const mp::Path&),
                 (override));
     MOCK_METHOD(void, remove, (const std::string&), (override));
+    MOCK_METHOD(VMImage, clone, (const std::string&, const std::string&, const Path&), (override));
     MOCK_METHOD(bool, has_record_for, (const std::string&), (override));
     MOCK_METHOD(void, prune_expired_images, (), (override));
     MOCK_METHOD(void, update_images, (const FetchType&, const PrepareAction&, const ProgressMonitor&), (override));
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MULTIPASS_MOCK_LINK_OPS_H
+#define MULTIPASS_MOCK_LINK_OPS_H
+
+#include "tests/common.h"
+#include "tests/mock_singleton_helpers.h"
+
+#include <src/platform/backends/qemu/linux/link_ops.h>
+
+namespace multipass::test
+{
+class MockLinkOps : public LinkOps
+{
+public:
+    using LinkOps::LinkOps;
+
+    MOCK_METHOD(bool, link_exists, (const QString&), (const, override));
+    MOCK_METHOD(void, delete_link, (const QString&), (const, override));
+    MOCK_METHOD(void, set_link_up, (const QString&, const QString&), (const, override));
+    MOCK_METHOD(void, create_bridge, (const QString&, const std::string&), (const, override));
+    MOCK_METHOD(void, add_ipv4_address, (const QString&, const std::string&, int, const std::string&),
+                (const, override));
+    MOCK_METHOD(void, create_tap, (const QString&, bool), (const, override));
+    MOCK_METHOD(std::optional<bool>, tap_is_multi_queue, (const QString&), (const, override));
+
+    MP_MOCK_SINGLETON_BOILERPLATE(MockLinkOps, LinkOps);
+};
+} // namespace multipass::test
+
+#endif // MULTIPASS_MOCK_LINK_OPS_H
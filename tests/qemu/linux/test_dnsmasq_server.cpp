@@ -123,6 +123,31 @@ TEST_F(DNSMasqServer, returns_null_ip_when_leases_file_does_not_exist)
     EXPECT_FALSE(ip);
 }
 
+TEST_F(DNSMasqServer, finds_ip_leased_after_previous_lookup)
+{
+    auto dns = make_default_dnsmasq_server();
+    ASSERT_FALSE(dns.get_ip_for(hw_addr));
+
+    make_lease_entry();
+    auto ip = dns.get_ip_for(hw_addr);
+
+    ASSERT_TRUE(ip);
+    EXPECT_EQ(ip.value(), mp::IPAddress(expected_ip));
+}
+
+TEST_F(DNSMasqServer, serves_known_ip_from_index)
+{
+    auto dns = make_default_dnsmasq_server();
+    make_lease_entry();
+    ASSERT_TRUE(dns.get_ip_for(hw_addr));
+
+    ASSERT_TRUE(QFile::remove(QDir{data_dir.path()}.filePath("dnsmasq.leases")));
+    auto ip = dns.get_ip_for(hw_addr);
+
+    ASSERT_TRUE(ip);
+    EXPECT_EQ(ip.value(), mp::IPAddress(expected_ip));
+}
+
 TEST_F(DNSMasqServer, release_mac_releases_ip)
 {
     const QString dchp_release_called{QDir{data_dir.path()}.filePath("dhcp_release_called")};
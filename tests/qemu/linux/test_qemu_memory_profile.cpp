@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "tests/common.h"
+#include "tests/mock_file_ops.h"
+
+#include <src/platform/backends/qemu/qemu_memory_profile.h>
+
+#include <multipass/constants.h>
+
+#include <sstream>
+
+namespace mp = multipass;
+namespace mpt = multipass::test;
+
+using namespace testing;
+
+namespace
+{
+struct QemuMemoryProfile : public Test
+{
+    void expect_read(const std::string& path, const std::string& contents)
+    {
+        EXPECT_CALL(mock_file_ops, open_read(mp::fs::path{path}, _)).WillOnce([contents](auto...) {
+            return std::make_unique<std::istringstream>(contents);
+        });
+    }
+
+    const mp::MemorySize mem_size{"1G"};
+    mpt::MockFileOps::GuardedMock mock_file_ops_injection = mpt::MockFileOps::inject<NiceMock>();
+    mpt::MockFileOps& mock_file_ops = *mock_file_ops_injection.first;
+};
+} // namespace
+
+TEST_F(QemuMemoryProfile, defaultNeedsNoBackend)
+{
+    const auto profile = mp::QemuMemoryProfile::parse(mp::default_memory_profile);
+
+    EXPECT_FALSE(profile.host_node);
+    EXPECT_TRUE(profile.backend_arguments(mem_size, false).isEmpty());
+    EXPECT_EQ(profile.backend_arguments(mem_size, true),
+              QStringList({"-object", "memory-backend-memfd,id=mem,size=1024M,share=on", "-numa", "node,memdev=mem"}));
+}
+
+TEST_F(QemuMemoryProfile, hugepagesAreBoundToHostNode)
+{
+    EXPECT_CALL(mock_file_ops, exists(mp::fs::path{"/sys/devices/system/node/node1"}, _)).WillOnce(Return(true));
+
+    const auto profile = mp::QemuMemoryProfile::parse("hugepages,node=1");
+
+    EXPECT_TRUE(profile.uses_hugepages());
+    EXPECT_EQ(profile.host_node, 1);
+    EXPECT_EQ(profile.backend_arguments(mem_size, false),
+              QStringList({"-object",
+                           "memory-backend-memfd,id=mem,size=1024M,hugetlb=on,prealloc=on,host-nodes=1,policy=bind",
+                           "-numa",
+                           "node,memdev=mem"}));
+}
+
+TEST_F(QemuMemoryProfile, preallocDoesNotUseHugepages)
+{
+    const auto profile = mp::QemuMemoryProfile::parse("prealloc");
+
+    EXPECT_FALSE(profile.uses_hugepages());
+    EXPECT_THAT(profile.backend_arguments(mem_size, false).join(' ').toStdString(),
+                AllOf(HasSubstr("prealloc=on"), Not(HasSubstr("hugetlb"))));
+}
+
+TEST_F(QemuMemoryProfile, rejectsUnknownProfiles)
+{
+    EXPECT_CALL(mock_file_ops, exists(mp::fs::path{"/sys/devices/system/node/node7"}, _)).WillOnce(Return(false));
+
+    MP_EXPECT_THROW_THAT(mp::QemuMemoryProfile::parse("gigapages"),
+                         std::invalid_argument,
+                         mpt::match_what(HasSubstr("Unknown memory profile")));
+    MP_EXPECT_THROW_THAT(mp::QemuMemoryProfile::parse("hugepages,numa=1"),
+                         std::invalid_argument,
+                         mpt::match_what(HasSubstr("Invalid memory profile option")));
+    MP_EXPECT_THROW_THAT(mp::QemuMemoryProfile::parse("hugepages,node=7"),
+                         std::invalid_argument,
+                         mpt::match_what(HasSubstr("Host NUMA node 7 not found")));
+}
+
+TEST_F(QemuMemoryProfile, checksFreeHugepagesOnHostNode)
+{
+    EXPECT_CALL(mock_file_ops, exists(mp::fs::path{"/sys/devices/system/node/node0"}, _)).WillOnce(Return(true));
+    expect_read("/proc/meminfo", "MemTotal:       16318412 kB\nHugepagesize:       2048 kB\n");
+    expect_read("/sys/devices/system/node/node0/hugepages/hugepages-2048kB/free_hugepages", "100\n");
+
+    MP_EXPECT_THROW_THAT(mp::QemuMemoryProfile::parse("hugepages,node=0").check_hugepages_available(mem_size),
+                         std::runtime_error,
+                         mpt::match_what(AllOf(HasSubstr("on host NUMA node 0"), HasSubstr("512"))));
+}
+
+TEST_F(QemuMemoryProfile, acceptsEnoughFreeHugepages)
+{
+    expect_read("/proc/meminfo", "Hugepagesize:       2048 kB\n");
+    expect_read("/sys/kernel/mm/hugepages/hugepages-2048kB/free_hugepages", "512\n");
+
+    EXPECT_NO_THROW(mp::QemuMemoryProfile::parse("hugepages").check_hugepages_available(mem_size));
+}
@@ -17,6 +17,7 @@
 
 #include "mock_dnsmasq_server.h"
 #include "mock_firewall_config.h"
+#include "mock_link_ops.h"
 
 #include "tests/common.h"
 #include "tests/mock_backend_utils.h"
@@ -28,6 +29,9 @@
 
 #include <src/platform/backends/qemu/linux/qemu_platform_detail.h>
 
+#include <cerrno>
+#include <cstring>
+
 namespace mp = multipass;
 namespace mpl = multipass::logging;
 namespace mpt = multipass::test;
@@ -52,9 +56,7 @@ struct QemuPlatformDetail : public Test
             return std::move(mock_firewall_config);
         });
 
-        EXPECT_CALL(*mock_utils, run_cmd_for_status(QString("ip"), _, _)).WillRepeatedly(Return(true));
-        EXPECT_CALL(*mock_utils,
-                    run_cmd_for_status(QString("ip"), QStringList({"addr", "show", multipass_bridge_name}), _))
+        EXPECT_CALL(*mock_link_ops, link_exists(multipass_bridge_name))
             .WillOnce(Return(false))
             .WillOnce(Return(true));
 
@@ -85,6 +87,9 @@ struct QemuPlatformDetail : public Test
         mpt::MockFirewallConfigFactory::inject<NiceMock>()};
     mpt::MockFirewallConfigFactory* mock_firewall_config_factory = firewall_config_factory_attr.first;
 
+    mpt::MockLinkOps::GuardedMock link_ops_attr{mpt::MockLinkOps::inject<NiceMock>()};
+    mpt::MockLinkOps* mock_link_ops = link_ops_attr.first;
+
     mpt::MockFileOps::GuardedMock file_ops_attr{mpt::MockFileOps::inject<NiceMock>()};
     mpt::MockFileOps* mock_file_ops = file_ops_attr.first;
 
@@ -94,24 +99,11 @@ struct QemuPlatformDetail : public Test
 
 TEST_F(QemuPlatformDetail, ctor_sets_up_expected_virtual_switch)
 {
-    const QString qstring_subnet{QString::fromStdString(subnet)};
-
-    EXPECT_CALL(*mock_utils, run_cmd_for_status(QString("ip"),
-                                                ElementsAre(QString("link"), QString("add"), multipass_bridge_name,
-                                                            QString("address"), _, QString("type"), QString("bridge")),
-                                                _))
-        .WillOnce(Return(true));
-    EXPECT_CALL(*mock_utils, run_cmd_for_status(QString("ip"),
-                                                ElementsAre(QString("address"), QString("add"),
-                                                            QString("%1.1/24").arg(qstring_subnet), QString("dev"),
-                                                            multipass_bridge_name, "broadcast",
-                                                            QString("%1.255").arg(qstring_subnet)),
-                                                _))
-        .WillOnce(Return(true));
-    EXPECT_CALL(*mock_utils, run_cmd_for_status(
-                                 QString("ip"),
-                                 ElementsAre(QString("link"), QString("set"), multipass_bridge_name, QString("up")), _))
-        .WillOnce(Return(true));
+    EXPECT_CALL(*mock_link_ops, create_bridge(multipass_bridge_name, _)).WillOnce(Return());
+    EXPECT_CALL(*mock_link_ops, add_ipv4_address(multipass_bridge_name, fmt::format("{}.1", subnet), 24,
+                                                 fmt::format("{}.255", subnet)))
+        .WillOnce(Return());
+    EXPECT_CALL(*mock_link_ops, set_link_up(multipass_bridge_name, QString())).WillOnce(Return());
 
     mp::QemuPlatformDetail qemu_platform_detail{data_dir.path()};
 }
@@ -132,6 +124,7 @@ TEST_F(QemuPlatformDetail, get_ip_for_returns_expected_info)
 TEST_F(QemuPlatformDetail, platform_args_generate_net_resources_removes_works_as_expected)
 {
     mp::VirtualMachineDescription vm_desc;
+    vm_desc.num_cores = 1;
     vm_desc.vm_name = "foo";
     vm_desc.default_mac_address = hw_addr;
 
@@ -139,14 +132,14 @@ TEST_F(QemuPlatformDetail, platform_args_generate_net_resources_removes_works_as
 
     EXPECT_CALL(*mock_dnsmasq_server, release_mac(hw_addr)).WillOnce(Return());
 
-    EXPECT_CALL(
-        *mock_utils,
-        run_cmd_for_status(QString("ip"),
-                           ElementsAre(QString("addr"), QString("show"), mpt::match_qstring(StartsWith("tap-"))), _))
-        .WillOnce([&tap_name](auto& cmd, auto& opts, auto...) {
-            tap_name = opts.last();
+    EXPECT_CALL(*mock_link_ops, link_exists(mpt::match_qstring(StartsWith("tap-"))))
+        .WillOnce([&tap_name](const QString& name) {
+            tap_name = name;
             return false;
         });
+    EXPECT_CALL(*mock_link_ops, create_tap(mpt::match_qstring(StartsWith("tap-")), false)).WillOnce(Return());
+    EXPECT_CALL(*mock_link_ops, set_link_up(mpt::match_qstring(StartsWith("tap-")), multipass_bridge_name))
+        .WillOnce(Return());
 
     mp::QemuPlatformDetail qemu_platform_detail{data_dir.path()};
 
@@ -160,23 +153,114 @@ TEST_F(QemuPlatformDetail, platform_args_generate_net_resources_removes_works_as
 #elif defined Q_PROCESSOR_ARM
         "-bios", "QEMU_EFI.fd",
 #endif
-            "--enable-kvm", "-cpu", "host", "-nic",
-            QString::fromStdString(fmt::format("tap,ifname={},script=no,downscript=no,model=virtio-net-pci,mac={}",
-                                               tap_name, vm_desc.default_mac_address))
+            "--enable-kvm", "-cpu", "host", "-netdev",
+            QString::fromStdString(fmt::format("tap,id=hostnet0,ifname={},script=no,downscript=no", tap_name)),
+            "-device",
+            QString::fromStdString(fmt::format("virtio-net-pci,netdev=hostnet0,mac={}", vm_desc.default_mac_address))
     };
 
     EXPECT_THAT(platform_args, ElementsAreArray(expected_platform_args));
 
-    EXPECT_CALL(*mock_utils,
-                run_cmd_for_status(QString("ip"), ElementsAre(QString("addr"), QString("show"), tap_name), _))
-        .WillOnce(Return(true));
-    EXPECT_CALL(*mock_utils,
-                run_cmd_for_status(QString("ip"), ElementsAre(QString("link"), QString("delete"), tap_name), _))
-        .WillOnce(Return(true));
+    EXPECT_CALL(*mock_link_ops, link_exists(tap_name)).WillOnce(Return(true));
+    EXPECT_CALL(*mock_link_ops, delete_link(tap_name)).WillOnce(Return());
 
     qemu_platform_detail.remove_resources_for(name);
 }
 
+TEST_F(QemuPlatformDetail, platform_args_use_multi_queue_vhost_net)
+{
+    mp::VirtualMachineDescription vm_desc;
+    vm_desc.num_cores = 4;
+    vm_desc.vm_name = "foo";
+    vm_desc.default_mac_address = hw_addr;
+
+    QString tap_name;
+
+    EXPECT_CALL(*mock_link_ops, link_exists(mpt::match_qstring(StartsWith("tap-"))))
+        .WillOnce([&tap_name](const QString& name) {
+            tap_name = name;
+            return false;
+        });
+    EXPECT_CALL(*mock_link_ops, create_tap(mpt::match_qstring(StartsWith("tap-")), true)).WillOnce(Return());
+    EXPECT_CALL(*mock_file_ops, exists(A<const QFileInfo&>())).WillRepeatedly([](const QFileInfo& file) {
+        return file.filePath() == "/dev/vhost-net";
+    });
+
+    mp::QemuPlatformDetail qemu_platform_detail{data_dir.path()};
+
+    const auto platform_args = qemu_platform_detail.vm_platform_args(vm_desc);
+
+    const auto netdev =
+        fmt::format("tap,id=hostnet0,ifname={},script=no,downscript=no,queues=4,vhost=on", tap_name);
+    const auto nic = fmt::format("virtio-net-pci,netdev=hostnet0,mac={},mq=on,vectors=10", vm_desc.default_mac_address);
+
+    EXPECT_THAT(platform_args, AllOf(Contains(QString::fromStdString(netdev)), Contains(QString::fromStdString(nic))));
+}
+
+TEST_F(QemuPlatformDetail, platform_args_recreate_single_queue_tap_device)
+{
+    mp::VirtualMachineDescription vm_desc;
+    vm_desc.num_cores = 2;
+    vm_desc.vm_name = "foo";
+    vm_desc.default_mac_address = hw_addr;
+
+    EXPECT_CALL(*mock_link_ops, link_exists(mpt::match_qstring(StartsWith("tap-")))).WillRepeatedly(Return(true));
+    EXPECT_CALL(*mock_link_ops, tap_is_multi_queue(_)).WillOnce(Return(false));
+
+    // Once to recreate it with multiple queues, once more on teardown
+    EXPECT_CALL(*mock_link_ops, delete_link(mpt::match_qstring(StartsWith("tap-")))).Times(2);
+    EXPECT_CALL(*mock_link_ops, create_tap(mpt::match_qstring(StartsWith("tap-")), true)).WillOnce(Return());
+
+    mp::QemuPlatformDetail qemu_platform_detail{data_dir.path()};
+
+    qemu_platform_detail.vm_platform_args(vm_desc);
+}
+
+TEST_F(QemuPlatformDetail, platform_args_keep_tap_device_with_matching_queues)
+{
+    mp::VirtualMachineDescription vm_desc;
+    vm_desc.num_cores = 2;
+    vm_desc.vm_name = "foo";
+    vm_desc.default_mac_address = hw_addr;
+
+    EXPECT_CALL(*mock_link_ops, link_exists(mpt::match_qstring(StartsWith("tap-")))).WillOnce(Return(true));
+    EXPECT_CALL(*mock_link_ops, tap_is_multi_queue(_)).WillOnce(Return(true));
+    EXPECT_CALL(*mock_link_ops, create_tap(_, _)).Times(0);
+
+    mp::QemuPlatformDetail qemu_platform_detail{data_dir.path()};
+
+    qemu_platform_detail.vm_platform_args(vm_desc);
+}
+
+TEST_F(QemuPlatformDetail, failing_to_delete_bridge_logs_warning)
+{
+    logger_scope.mock_logger->screen_logs(mpl::Level::warning);
+    logger_scope.mock_logger->expect_log(mpl::Level::warning, "failed to delete link mpqemubr0");
+
+    EXPECT_CALL(*mock_link_ops, delete_link(multipass_bridge_name))
+        .WillOnce(Throw(mp::LinkOpsException{EBUSY, "delete link", multipass_bridge_name}));
+
+    mp::QemuPlatformDetail qemu_platform_detail{data_dir.path()};
+}
+
+TEST_F(QemuPlatformDetail, failing_to_create_tap_device_throws)
+{
+    mp::VirtualMachineDescription vm_desc;
+    vm_desc.num_cores = 1;
+    vm_desc.vm_name = "foo";
+    vm_desc.default_mac_address = hw_addr;
+
+    EXPECT_CALL(*mock_link_ops, create_tap(_, false)).WillOnce([](const QString& name, auto) {
+        throw mp::LinkOpsException{EPERM, "create tap device", name};
+    });
+
+    mp::QemuPlatformDetail qemu_platform_detail{data_dir.path()};
+
+    MP_EXPECT_THROW_THAT(qemu_platform_detail.vm_platform_args(vm_desc), mp::LinkOpsException,
+                         mpt::match_what(AllOf(HasSubstr("failed to create tap device tap-"),
+                                               HasSubstr(std::strerror(EPERM)))));
+}
+
 TEST_F(QemuPlatformDetail, platform_health_check_calls_expected_methods)
 {
     EXPECT_CALL(*mock_backend, check_for_kvm_support()).WillOnce(Return());
@@ -37,6 +37,7 @@
 #include <src/platform/backends/qemu/qemu_virtual_machine_factory.h>
 
 #include <multipass/auto_join_thread.h>
+#include <multipass/constants.h>
 #include <multipass/exceptions/start_exception.h>
 #include <multipass/exceptions/virtual_machine_state_exceptions.h>
 #include <multipass/memory_size.h>
@@ -46,10 +47,17 @@
 #include <multipass/virtual_machine_description.h>
 #include <multipass/vm_specs.h>
 
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QThread>
+#include <QTimer>
 
+#include <future>
 #include <thread>
 
 namespace mp = multipass;
@@ -159,6 +167,35 @@ struct QemuBackend : public mpt::TestWithMockedBinPath
                             emit process->ready_read_standard_output();
                         }
                     }
+                    else if (execute == "migrate")
+                    {
+                        // stand in for the state file that QEMU would write
+                        const auto uri = json_object["arguments"].toObject()["uri"].toString();
+                        const auto partial_file = uri.section("file:", 1);
+                        QDir{}.mkpath(QFileInfo{partial_file}.path());
+                        QFile{partial_file}.open(QIODevice::WriteOnly);
+
+                        EXPECT_CALL(*process, read_all_standard_output())
+                            .WillRepeatedly(Return("{\"timestamp\": {\"seconds\": 1541188919, \"microseconds\": "
+                                                   "838498}, \"event\": \"MIGRATION\", \"data\": {\"status\": "
+                                                   "\"completed\"}}"));
+
+                        EXPECT_CALL(*process, kill()).WillOnce([process] {
+                            mp::ProcessState exit_state{
+                                std::nullopt, mp::ProcessState::Error{QProcess::Crashed, QStringLiteral("")}};
+                            emit process->error_occurred(QProcess::Crashed, "Crashed");
+                            emit process->finished(exit_state);
+                        });
+                        emit process->ready_read_standard_output();
+                    }
+                    else if (execute == "migrate-incoming")
+                    {
+                        EXPECT_CALL(*process, read_all_standard_output())
+                            .WillRepeatedly(Return("{\"timestamp\": {\"seconds\": 1541188919, \"microseconds\": "
+                                                   "838498}, \"event\": \"MIGRATION\", \"data\": {\"status\": "
+                                                   "\"completed\"}}"));
+                        emit process->ready_read_standard_output();
+                    }
                 }
 
                 return data.size();
@@ -262,6 +299,179 @@ TEST_F(QemuBackend, machine_start_suspend_sends_monitoring_event)
     machine->suspend();
 }
 
+TEST_F(QemuBackend, machineSuspendedToFileKeepsStateFileAndResumesFromIt)
+{
+    EXPECT_CALL(*mock_qemu_platform_factory, make_qemu_platform(_)).WillOnce([this](auto...) {
+        return std::move(mock_qemu_platform);
+    });
+
+    NiceMock<mpt::MockVMStatusMonitor> mock_monitor;
+    mp::QemuVirtualMachineFactory backend{data_dir.path(), /* suspend_to_file = */ true};
+
+    process_factory->register_callback([](mpt::MockProcess* process) {
+        handle_qemu_system(process);
+
+        // the guest was stopped when suspended, so it must be continued once its state is back in
+        if (process->arguments().contains("-incoming"))
+            EXPECT_CALL(*process, write(Truly([](const QByteArray& data) {
+                            return QJsonDocument::fromJson(data).object()["execute"] == "cont";
+                        })))
+                .WillOnce([](const QByteArray& data) { return data.size(); });
+    });
+
+    auto machine = backend.create_virtual_machine(default_description, key_provider, mock_monitor);
+    machine->start();
+    machine->state = mp::VirtualMachine::State::running;
+
+    EXPECT_CALL(mock_monitor, on_suspend());
+    machine->suspend();
+    EXPECT_EQ(machine->current_state(), mp::VirtualMachine::State::suspended);
+
+    const auto suspend_state_file = QDir{backend.get_instance_directory(default_description.vm_name)}.filePath(
+        "suspend.vmstate");
+    EXPECT_TRUE(QFile::exists(suspend_state_file));
+    EXPECT_FALSE(QFile::exists(suspend_state_file + ".part"));
+
+    auto resumed_machine = backend.create_virtual_machine(default_description, key_provider, mock_monitor);
+    EXPECT_EQ(resumed_machine->current_state(), mp::VirtualMachine::State::suspended);
+
+    resumed_machine->start();
+    resumed_machine->state = mp::VirtualMachine::State::running;
+
+    const auto qemu = process_factory->process_list().back();
+    EXPECT_TRUE(qemu.arguments.contains("-incoming"));
+    EXPECT_FALSE(qemu.arguments.contains("-loadvm"));
+}
+
+struct VirtiofsQemuVM : public mp::QemuVirtualMachine
+{
+    using mp::QemuVirtualMachine::QemuVirtualMachine;
+
+    MOCK_METHOD(std::string, ssh_exec, (const std::string& cmd, bool whisper), (override));
+};
+
+struct QemuBackendVirtiofsSuspend : public QemuBackend
+{
+    void SetUp() override
+    {
+        process_factory->register_callback([this](mpt::MockProcess* process) {
+            handle_qemu_system(process);
+
+            if (!process->program().contains("qemu-system"))
+                return;
+
+            qemu = process;
+            EXPECT_CALL(*process, write(Truly([](const QByteArray& data) {
+                            return QJsonDocument::fromJson(data).object()["execute"] == "device_del";
+                        })))
+                .WillRepeatedly([this, process](const QByteArray& data) {
+                    ++device_dels;
+                    if (devices_go_away)
+                    {
+                        const auto id = QJsonDocument::fromJson(data).object()["arguments"].toObject()["id"];
+                        const auto event = QJsonObject{{"event", "DEVICE_DELETED"},
+                                                       {"data", QJsonObject{{"device", id}}}};
+                        EXPECT_CALL(*process, read_all_standard_output())
+                            .WillOnce(Return(QJsonDocument{event}.toJson(QJsonDocument::Compact)));
+                        emit process->ready_read_standard_output();
+                    }
+                    return data.size();
+                });
+        });
+
+        machine.start();
+        machine.state = mp::VirtualMachine::State::running;
+        machine.modifiable_virtiofs_shares()[tag] = {"/home/ubuntu/src", "virtiofs.sock", {1000, 1000}, {1000, 1000}};
+
+        ON_CALL(machine, ssh_exec(HasSubstr("findmnt --list"), _)).WillByDefault(Return(tag + " " + target + "\n"));
+    }
+
+    void TearDown() override
+    {
+        machine.modifiable_virtiofs_shares().clear(); // no guest to unmount from when the machine goes away
+    }
+
+    const std::string tag{"share0"};
+    const std::string target{"/home/ubuntu/target"};
+    NiceMock<mpt::MockQemuPlatform> mock_qemu_platform;
+    NiceMock<VirtiofsQemuVM> machine{default_description,
+                                     &mock_qemu_platform,
+                                     stub_monitor,
+                                     key_provider,
+                                     instance_dir.path()};
+    mpt::MockProcess* qemu{nullptr};
+    int device_dels{0};
+    bool devices_go_away{true};
+};
+
+TEST_F(QemuBackendVirtiofsSuspend, unplugsVirtiofsDevicesBeforeSuspending)
+{
+    EXPECT_CALL(machine, ssh_exec("sudo umount --all --types virtiofs", _));
+
+    machine.suspend();
+
+    EXPECT_EQ(device_dels, 1);
+    EXPECT_EQ(machine.current_state(), mp::VirtualMachine::State::suspended);
+}
+
+TEST_F(QemuBackendVirtiofsSuspend, refusesToSuspendWhenVirtiofsSharesCannotBeUnmounted)
+{
+    EXPECT_CALL(machine, ssh_exec("sudo umount --all --types virtiofs", _))
+        .WillOnce(Throw(std::runtime_error{"target is busy"}));
+    EXPECT_CALL(machine, ssh_exec(AllOf(HasSubstr("mount -t virtiofs"), HasSubstr(target)), _));
+
+    MP_EXPECT_THROW_THAT(machine.suspend(), std::runtime_error, mpt::match_what(HasSubstr("target is busy")));
+
+    EXPECT_EQ(device_dels, 0);
+    EXPECT_EQ(machine.current_state(), mp::VirtualMachine::State::running);
+}
+
+TEST_F(QemuBackendVirtiofsSuspend, abortsSuspendingWhenVirtiofsDevicesAreNotUnplugged)
+{
+    devices_go_away = false;
+    EXPECT_CALL(*qemu, wait_for_ready_read(_)).WillOnce(Return(false));
+    EXPECT_CALL(machine, ssh_exec(AllOf(HasSubstr("mount -t virtiofs"), HasSubstr(target)), _));
+
+    MP_EXPECT_THROW_THAT(machine.suspend(), std::runtime_error, mpt::match_what(HasSubstr("suspension aborted")));
+
+    EXPECT_EQ(device_dels, 1);
+    EXPECT_EQ(machine.current_state(), mp::VirtualMachine::State::running);
+}
+
+TEST_F(QemuBackend, rejectsUnknownDiskProfile)
+{
+    EXPECT_CALL(*mock_qemu_platform_factory, make_qemu_platform(_)).WillOnce([this](auto...) {
+        return std::move(mock_qemu_platform);
+    });
+
+    mpt::StubVMStatusMonitor stub_monitor;
+    mp::QemuVirtualMachineFactory backend{data_dir.path()};
+
+    auto machine = backend.create_virtual_machine(default_description, key_provider, stub_monitor);
+
+    MP_EXPECT_THROW_THAT(machine->update_disk_profile("turbo"),
+                         std::invalid_argument,
+                         mpt::match_what(HasSubstr("Unknown disk profile")));
+    EXPECT_NO_THROW(machine->update_disk_profile(mp::default_disk_profile));
+}
+
+TEST_F(QemuBackend, rejectsUnknownMemoryProfile)
+{
+    EXPECT_CALL(*mock_qemu_platform_factory, make_qemu_platform(_)).WillOnce([this](auto...) {
+        return std::move(mock_qemu_platform);
+    });
+
+    mpt::StubVMStatusMonitor stub_monitor;
+    mp::QemuVirtualMachineFactory backend{data_dir.path()};
+
+    auto machine = backend.create_virtual_machine(default_description, key_provider, stub_monitor);
+
+    MP_EXPECT_THROW_THAT(machine->update_memory_profile("gigapages"),
+                         std::invalid_argument,
+                         mpt::match_what(HasSubstr("Unknown memory profile")));
+    EXPECT_NO_THROW(machine->update_memory_profile(mp::default_memory_profile));
+}
+
 TEST_F(QemuBackend, throws_when_shutdown_while_starting)
 {
     mpt::MockProcess* vmproc = nullptr;
@@ -809,6 +1019,32 @@ TEST_F(QemuBackend, ssh_hostname_returns_expected_value)
     EXPECT_EQ(machine.VirtualMachine::ssh_hostname(), expected_ip);
 }
 
+TEST_F(QemuBackend, balloonTimerStartsWithTheMachineWhenConstructedOffTheMainThread)
+{
+    NiceMock<mpt::MockQemuPlatform> mock_qemu_platform;
+
+    auto machine = std::async(std::launch::async, [&] {
+                       auto vm = std::make_unique<mp::QemuVirtualMachine>(default_description,
+                                                                          &mock_qemu_platform,
+                                                                          stub_monitor,
+                                                                          key_provider,
+                                                                          instance_dir.path(),
+                                                                          false,
+                                                                          false,
+                                                                          true);
+                       vm->moveToThread(QCoreApplication::instance()->thread());
+                       return vm;
+                   }).get();
+
+    auto balloon_timer = machine->findChild<QTimer*>();
+    ASSERT_NE(balloon_timer, nullptr);
+    EXPECT_EQ(balloon_timer->thread(), QThread::currentThread());
+    EXPECT_FALSE(balloon_timer->isActive());
+
+    machine->start();
+    EXPECT_TRUE(balloon_timer->isActive());
+}
+
 TEST_F(QemuBackend, gets_management_ip)
 {
     mpt::StubVMStatusMonitor stub_monitor;
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "tests/common.h"
+#include "tests/mock_file_ops.h"
+
+#include <src/platform/backends/qemu/qemu_balloon_policy.h>
+
+#include <sstream>
+
+namespace mp = multipass;
+namespace mpt = multipass::test;
+
+using namespace testing;
+
+namespace
+{
+struct QemuBalloonPolicy : public Test
+{
+    void expect_pressure(const std::string& contents)
+    {
+        EXPECT_CALL(mock_file_ops, open_read(mp::fs::path{"/proc/pressure/memory"}, _)).WillOnce([contents](auto...) {
+            return std::make_unique<std::istringstream>(contents);
+        });
+    }
+
+    const mp::MemorySize mem_size{"1000"};
+    mp::QemuBalloonPolicy policy;
+    mpt::MockFileOps::GuardedMock mock_file_ops_injection = mpt::MockFileOps::inject<NiceMock>();
+    mpt::MockFileOps& mock_file_ops = *mock_file_ops_injection.first;
+};
+} // namespace
+
+TEST_F(QemuBalloonPolicy, readsSomeAvg10)
+{
+    expect_pressure("some avg10=12.34 avg60=5.00 avg300=1.00 total=123456\n"
+                    "full avg10=2.00 avg60=1.00 avg300=0.50 total=23456\n");
+
+    EXPECT_EQ(mp::QemuBalloonPolicy::host_memory_pressure(), 12.34);
+}
+
+TEST_F(QemuBalloonPolicy, noPressureWithoutPsi)
+{
+    expect_pressure("");
+
+    EXPECT_EQ(mp::QemuBalloonPolicy::host_memory_pressure(), std::nullopt);
+}
+
+TEST_F(QemuBalloonPolicy, shrinksUnderPressureDownToMinimum)
+{
+    for (auto percent = 90; percent >= mp::QemuBalloonPolicy::min_percent; percent -= 10)
+        EXPECT_EQ(policy.next_target(50.0, mem_size), percent * 10);
+
+    EXPECT_EQ(policy.next_target(50.0, mem_size), std::nullopt);
+}
+
+TEST_F(QemuBalloonPolicy, growsBackOnceCalm)
+{
+    EXPECT_EQ(policy.next_target(50.0, mem_size), 900);
+    EXPECT_EQ(policy.next_target(5.0, mem_size), std::nullopt); // neither high nor low, stays
+    EXPECT_EQ(policy.next_target(0.0, mem_size), 1000);
+    EXPECT_EQ(policy.next_target(0.0, mem_size), std::nullopt);
+}
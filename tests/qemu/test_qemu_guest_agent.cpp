@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "tests/common.h"
+#include "tests/temp_dir.h"
+
+#include <src/platform/backends/qemu/qemu_guest_agent.h>
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QLocalServer>
+#include <QLocalSocket>
+
+#include <functional>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+namespace mp = multipass;
+namespace mpt = multipass::test;
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+// Stand-in for the agent end of the virtio-serial channel: serves one connection on its own thread, answering each
+// request line with whatever the responder returns (nothing, if it returns an empty object). Like the agent, it skips
+// leading delimiter bytes and marks its replies to guest-sync-delimited with one.
+class StandInGuestAgent
+{
+public:
+    using Responder = std::function<QJsonObject(const QJsonObject& request)>;
+
+    StandInGuestAgent(const QString& socket_path, Responder responder)
+    {
+        std::promise<void> listening;
+        auto listening_future = listening.get_future();
+
+        agent_thread = std::thread{[socket_path, responder = std::move(responder), &listening] {
+            QLocalServer server;
+            server.listen(socket_path);
+            listening.set_value();
+
+            if (!server.waitForNewConnection(5000))
+                return;
+
+            auto connection = server.nextPendingConnection();
+            while (connection->canReadLine() || connection->waitForReadyRead(5000))
+            {
+                while (connection->canReadLine())
+                {
+                    auto line = connection->readLine();
+                    while (line.startsWith('\xff'))
+                        line.remove(0, 1);
+
+                    const auto request = QJsonDocument::fromJson(line).object();
+                    const auto reply = responder(request);
+                    if (!reply.isEmpty())
+                    {
+                        const auto delimited = request["execute"].toString() == "guest-sync-delimited";
+                        connection->write((delimited ? QByteArray{"\xff"} : QByteArray{}) +
+                                          QJsonDocument{reply}.toJson(QJsonDocument::Compact) + '\n');
+                        connection->waitForBytesWritten(5000);
+                    }
+                }
+            }
+        }};
+
+        listening_future.wait();
+    }
+
+    ~StandInGuestAgent()
+    {
+        agent_thread.join();
+    }
+
+private:
+    std::thread agent_thread;
+};
+
+QJsonObject reply_to_sync(const QJsonObject& request)
+{
+    return {{"return", request["arguments"].toObject().value("id")}};
+}
+
+struct QemuGuestAgent : public Test
+{
+    mpt::TempDir temp_dir;
+    const QString socket_path{temp_dir.filePath("qga.sock")};
+};
+
+TEST_F(QemuGuestAgent, executesCommandsAfterSyncing)
+{
+    StandInGuestAgent agent{socket_path, [](const QJsonObject& request) {
+                                if (request["execute"].toString() == "guest-sync-delimited")
+                                    return reply_to_sync(request);
+
+                                EXPECT_EQ(request["execute"].toString(), "guest-info");
+                                return QJsonObject{{"return", QJsonObject{{"version", "8.2.2"}}}};
+                            }};
+
+    const auto result = mp::QemuGuestAgent{socket_path}.execute("guest-info");
+
+    EXPECT_EQ(result.toObject()["version"].toString(), "8.2.2");
+}
+
+TEST_F(QemuGuestAgent, getsIPv4AddressesOfNonLoopbackInterfaces)
+{
+    const auto interfaces = QJsonDocument::fromJson(R"([
+        {"name": "lo", "ip-addresses": [{"ip-address-type": "ipv4", "ip-address": "127.0.0.1", "prefix": 8}]},
+        {"name": "ens3", "ip-addresses": [{"ip-address-type": "ipv4", "ip-address": "10.1.2.3", "prefix": 24},
+                                          {"ip-address-type": "ipv6", "ip-address": "fe80::1", "prefix": 64}]},
+        {"name": "ens4", "ip-addresses": [{"ip-address-type": "ipv4", "ip-address": "169.254.0.7", "prefix": 16},
+                                          {"ip-address-type": "ipv4", "ip-address": "192.168.7.8", "prefix": 24}]}
+    ])")
+                                .array();
+
+    StandInGuestAgent agent{socket_path, [&interfaces](const QJsonObject& request) {
+                                if (request["execute"].toString() == "guest-sync-delimited")
+                                    return reply_to_sync(request);
+
+                                return QJsonObject{{"return", interfaces}};
+                            }};
+
+    EXPECT_THAT(mp::QemuGuestAgent{socket_path}.get_all_ipv4(), ElementsAre("10.1.2.3", "192.168.7.8"));
+}
+
+TEST_F(QemuGuestAgent, throwsOnAgentErrors)
+{
+    StandInGuestAgent agent{socket_path, [](const QJsonObject& request) {
+                                if (request["execute"].toString() == "guest-sync-delimited")
+                                    return reply_to_sync(request);
+
+                                return QJsonObject{{"error", QJsonObject{{"desc", "Command not found"}}}};
+                            }};
+
+    MP_EXPECT_THROW_THAT(mp::QemuGuestAgent{socket_path}.execute("guest-nope"),
+                         std::runtime_error,
+                         mpt::match_what(AllOf(HasSubstr("guest-nope"), HasSubstr("Command not found"))));
+}
+
+TEST_F(QemuGuestAgent, throwsWhenAgentDoesNotRespond)
+{
+    StandInGuestAgent agent{socket_path, [](const QJsonObject&) { return QJsonObject{}; }};
+
+    MP_EXPECT_THROW_THAT(mp::QemuGuestAgent(socket_path, 100ms).execute("guest-info"),
+                         std::runtime_error,
+                         mpt::match_what(HasSubstr("timed out")));
+}
+
+TEST_F(QemuGuestAgent, givesUpSoonWhenAgentIsNotRunning)
+{
+    StandInGuestAgent agent{socket_path, [](const QJsonObject&) { return QJsonObject{}; }};
+
+    const auto start = std::chrono::steady_clock::now();
+    MP_EXPECT_THROW_THAT(mp::QemuGuestAgent(socket_path, 10s, 100ms).execute("guest-info"),
+                         std::runtime_error,
+                         mpt::match_what(HasSubstr("timed out")));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 5s);
+}
+
+TEST_F(QemuGuestAgent, throwsWhenChannelIsMissing)
+{
+    MP_EXPECT_THROW_THAT(mp::QemuGuestAgent{socket_path}.execute("guest-info"),
+                         std::runtime_error,
+                         mpt::match_what(HasSubstr("cannot connect")));
+}
+} // namespace
@@ -17,12 +17,16 @@
 
 #include "tests/common.h"
 #include "tests/mock_process_factory.h"
+#include "tests/temp_dir.h"
 
 #include <src/platform/backends/shared/qemu_img_utils/qemu_img_utils.h>
 
 #include <multipass/constants.h>
 #include <multipass/memory_size.h>
 
+#include <QDataStream>
+#include <QFile>
+
 namespace mp = multipass;
 namespace mpt = multipass::test;
 
@@ -95,6 +99,40 @@ void simulate_qemuimg_convert(const mpt::MockProcess* process, const QString& im
     EXPECT_CALL(*process, execute).WillOnce(Return(produce_result));
 }
 
+// a bare QCOW2 image: no clusters allocated, just the header and (optionally) a snapshot table
+void write_qcow2_image(const QString& path, quint32 version, const QStringList& snapshot_tags)
+{
+    constexpr quint64 snapshots_offset = 512;
+
+    QByteArray header;
+    QDataStream header_stream{&header, QIODevice::WriteOnly};
+    header_stream << quint32{0x514649fb} << version;
+    header_stream.writeRawData(QByteArray(52, '\0').constData(), 52);
+    header_stream << quint32(snapshot_tags.size()) << (snapshot_tags.isEmpty() ? quint64{0} : snapshots_offset);
+
+    QByteArray table;
+    QDataStream table_stream{&table, QIODevice::WriteOnly};
+    for (auto i = 0; i < snapshot_tags.size(); ++i)
+    {
+        const auto id = QByteArray::number(i + 1);
+        const auto name = snapshot_tags[i].toUtf8();
+        const auto extra_data = QByteArray(16, '\0');
+
+        table_stream << quint64{0} << quint32{0} << quint16(id.size()) << quint16(name.size()) << quint32{0}
+                     << quint32{0} << quint64{0} << quint32{0} << quint32(extra_data.size());
+        table_stream.writeRawData(extra_data.constData(), extra_data.size());
+        table_stream.writeRawData(id.constData(), id.size());
+        table_stream.writeRawData(name.constData(), name.size());
+
+        const auto entry_size = 40 + extra_data.size() + id.size() + name.size();
+        table_stream.writeRawData(QByteArray(8, '\0').constData(), (8 - entry_size % 8) % 8);
+    }
+
+    QFile file{path};
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(header.leftJustified(snapshots_offset, '\0') + table);
+}
+
 template <class Matcher>
 void test_image_resizing(const char* img, const mp::MemorySize& img_virtual_size, const mp::MemorySize& requested_size,
                          const mp::ProcessState& qemuimg_resize_result, std::optional<Matcher> throw_msg_matcher)
@@ -217,3 +255,86 @@ TEST_P(ImageConversionTestSuite, properly_handles_image_conversion)
 }
 
 INSTANTIATE_TEST_SUITE_P(QemuImgUtils, ImageConversionTestSuite, ValuesIn(image_conversion_inputs));
+
+TEST(QemuImgUtils, readsSnapshotTagsWithoutQemuImg)
+{
+    mpt::TempDir dir;
+    const auto img = dir.filePath("img.qcow2");
+    write_qcow2_image(img, 3, {"@s1", "suspend", "a-much-longer-snapshot-tag"});
+
+    auto mock_factory_scope = mpt::MockProcessFactory::Inject();
+
+    EXPECT_TRUE(mp::backend::instance_image_has_snapshot(img, "suspend"));
+    EXPECT_TRUE(mp::backend::instance_image_has_snapshot(img, "a-much-longer-snapshot-tag"));
+    EXPECT_FALSE(mp::backend::instance_image_has_snapshot(img, "@s2"));
+    EXPECT_THAT(mock_factory_scope->process_list(), IsEmpty());
+}
+
+TEST(QemuImgUtils, rereadsImageAfterItChanges)
+{
+    mpt::TempDir dir;
+    const auto img = dir.filePath("img.qcow2");
+    write_qcow2_image(img, 3, {"@s1"});
+
+    ASSERT_TRUE(mp::backend::instance_image_has_snapshot(img, "@s1"));
+
+    write_qcow2_image(img, 3, {"@s1", "@s2"});
+    EXPECT_TRUE(mp::backend::instance_image_has_snapshot(img, "@s2"));
+}
+
+TEST(QemuImgUtils, forgetsCachedInfoWhenQemuImgRunsOnImage)
+{
+    mpt::TempDir dir;
+    const auto img = dir.filePath("img.qcow2");
+    write_qcow2_image(img, 2, {});
+
+    ASSERT_EQ(mp::backend::read_qcow2_info(img)->version, 2);
+
+    auto mock_factory_scope = mpt::MockProcessFactory::Inject();
+    mock_factory_scope->register_callback([&img](mpt::MockProcess* process) {
+        EXPECT_THAT(process->arguments(), ElementsAre("amend", "-o", "compat=1.1", img));
+        EXPECT_CALL(*process, execute).WillOnce([&img](auto...) {
+            write_qcow2_image(img, 3, {}); // same size, possibly the same modification time
+            return success;
+        });
+    });
+
+    mp::backend::amend_to_qcow2_v3(img);
+
+    EXPECT_EQ(mp::backend::read_qcow2_info(img)->version, 3);
+    EXPECT_EQ(mock_factory_scope->process_list().size(), 1u);
+}
+
+TEST(QemuImgUtils, skipsAmendingImagesAlreadyAtQcow2V3)
+{
+    mpt::TempDir dir;
+    const auto img = dir.filePath("img.qcow2");
+    write_qcow2_image(img, 3, {});
+
+    auto mock_factory_scope = mpt::MockProcessFactory::Inject();
+
+    mp::backend::amend_to_qcow2_v3(img);
+    EXPECT_THAT(mock_factory_scope->process_list(), IsEmpty());
+}
+
+TEST(QemuImgUtils, fallsBackToQemuImgForOtherImages)
+{
+    mpt::TempDir dir;
+    const auto img = dir.filePath("img.raw");
+    QFile file{img};
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("not a qcow2 image");
+    file.close();
+
+    EXPECT_FALSE(mp::backend::read_qcow2_info(img));
+
+    auto mock_factory_scope = mpt::MockProcessFactory::Inject();
+    mock_factory_scope->register_callback([](mpt::MockProcess* process) {
+        EXPECT_CALL(*process, execute).WillOnce(Return(success));
+        EXPECT_CALL(*process, read_all_standard_output).WillOnce(Return("2  @s1  0 B  2024-01-01 00:00:00\n"));
+    });
+
+    EXPECT_TRUE(mp::backend::instance_image_has_snapshot(img, "@s1"));
+    ASSERT_EQ(mock_factory_scope->process_list().size(), 1u);
+    EXPECT_THAT(mock_factory_scope->process_list().front().arguments, ElementsAre("snapshot", "-l", img));
+}
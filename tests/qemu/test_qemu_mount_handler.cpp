@@ -44,6 +44,7 @@ struct MockQemuVirtualMachine : mpt::MockVirtualMachineT<mp::QemuVirtualMachine>
     }
 
     MOCK_METHOD(mp::QemuVirtualMachine::MountArgs&, modifiable_mount_args, (), (override));
+    MOCK_METHOD(bool, uses_virtiofs_mounts, (), (const, override));
 };
 
 struct CommandOutput
@@ -204,6 +205,60 @@ TEST_F(QemuMountHandlerTest, mount_handles_mount_args)
     EXPECT_EQ(mount_args.size(), 0);
 }
 
+TEST_F(QemuMountHandlerTest, mount_handles_virtiofs_mount_args)
+{
+    EXPECT_CALL(vm, uses_virtiofs_mounts).WillOnce(Return(true));
+    const auto tag = tag_from_target(default_target);
+    auto& shares = vm.modifiable_virtiofs_shares();
+
+    {
+        mp::QemuMountHandler mount_handler{&vm, &key_provider, default_target, mount};
+
+        ASSERT_EQ(shares.count(tag), 1);
+        const auto& share = shares.at(tag);
+        EXPECT_EQ(share.source, mount.get_source_path());
+        EXPECT_EQ(share.uid_map, uid_mappings.front());
+        EXPECT_EQ(share.gid_map, gid_mappings.front());
+        EXPECT_TRUE(share.socket_path.startsWith(vm.instance_directory().absolutePath()));
+
+        ASSERT_EQ(mount_args.count(tag), 1);
+        EXPECT_EQ(mount_args.at(tag).second.join(' ').toStdString(),
+                  fmt::format("-chardev socket,id={0},path={1} -device vhost-user-fs-pci,id={0},chardev={0},tag={0}",
+                              tag,
+                              share.socket_path));
+    }
+
+    EXPECT_TRUE(shares.empty());
+    EXPECT_TRUE(mount_args.empty());
+}
+
+TEST_F(QemuMountHandlerTest, recover_virtiofs_mount_from_suspended_regardless_of_setting)
+{
+    const auto tag = tag_from_target(default_target);
+    mount_args[tag] = {default_source, {"-device", fmt::format("vhost-user-fs-pci,id={0},chardev={0},tag={0}", tag)}};
+    EXPECT_CALL(vm, current_state()).WillOnce(Return(mp::VirtualMachine::State::suspended));
+    EXPECT_CALL(vm, uses_virtiofs_mounts).WillOnce(Return(false));
+
+    mp::QemuMountHandler mount_handler{&vm, &key_provider, default_target, mount};
+    EXPECT_EQ(vm.modifiable_virtiofs_shares().count(tag), 1);
+}
+
+TEST_F(QemuMountHandlerTest, virtiofs_start_success_stop_success)
+{
+    EXPECT_CALL(vm, uses_virtiofs_mounts).WillOnce(Return(true));
+    const auto tag = tag_from_target(default_target);
+    command_outputs.insert({fmt::format("sudo mount -t virtiofs {} {}", tag, default_target), {""}});
+    command_outputs.insert({fmt::format("findmnt --type virtiofs | grep '{} {}'", default_target, tag), {""}});
+
+    std::string ssh_command_output;
+    REPLACE(ssh_channel_request_exec, mocked_ssh_channel_request_exec(ssh_command_output));
+    REPLACE(ssh_channel_read_timeout, mocked_ssh_channel_read_timeout(ssh_command_output));
+
+    mp::QemuMountHandler handler{&vm, &key_provider, default_target, mount};
+    EXPECT_NO_THROW(handler.activate(&server));
+    EXPECT_NO_THROW(handler.deactivate());
+}
+
 TEST_F(QemuMountHandlerTest, mount_logs_init)
 {
     logger_scope.mock_logger->expect_log(
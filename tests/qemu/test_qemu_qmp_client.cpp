@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "tests/common.h"
+
+#include <src/platform/backends/qemu/qemu_qmp_client.h>
+
+#include <QJsonDocument>
+
+#include <chrono>
+#include <utility>
+#include <vector>
+
+namespace mp = multipass;
+namespace mpt = multipass::test;
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+struct QemuQmpClient : public Test
+{
+    QJsonObject written(int index) const
+    {
+        return QJsonDocument::fromJson(writes.at(index)).object();
+    }
+
+    std::vector<QByteArray> writes;
+    std::vector<std::pair<QString, QJsonObject>> events;
+    mp::QmpClient qmp{[this](const QByteArray& data) { writes.push_back(data); },
+                      [this](const QString& event, const QJsonObject& data) { events.emplace_back(event, data); }};
+};
+} // namespace
+
+TEST_F(QemuQmpClient, writesOneCommandPerLine)
+{
+    qmp.execute("set_link", {{"name", "virtio-net-pci.0"}, {"up", false}});
+
+    ASSERT_EQ(writes.size(), 1u);
+    EXPECT_TRUE(writes[0].endsWith('\n'));
+    EXPECT_EQ(writes[0].count('\n'), 1);
+
+    const auto command = written(0);
+    EXPECT_EQ(command["execute"].toString(), "set_link");
+    EXPECT_EQ(command["arguments"].toObject()["name"].toString(), "virtio-net-pci.0");
+    EXPECT_TRUE(command.contains("id"));
+}
+
+TEST_F(QemuQmpClient, matchesRepliesToPipelinedCommands)
+{
+    auto status = qmp.execute("query-status");
+    auto balloon = qmp.execute("query-balloon");
+
+    const auto status_id = written(0)["id"].toInteger();
+    const auto balloon_id = written(1)["id"].toInteger();
+    ASSERT_NE(status_id, balloon_id);
+
+    qmp.handle_output(QString{"{\"return\": {\"actual\": 1024}, \"id\": %1}\n"
+                              "{\"return\": {\"status\": \"running\"}, \"id\": %2}\n"}
+                          .arg(balloon_id)
+                          .arg(status_id)
+                          .toUtf8());
+
+    ASSERT_EQ(status.wait_for(0s), std::future_status::ready);
+    ASSERT_EQ(balloon.wait_for(0s), std::future_status::ready);
+    EXPECT_EQ(status.get().toObject()["status"].toString(), "running");
+    EXPECT_EQ(balloon.get().toObject()["actual"].toInt(), 1024);
+}
+
+TEST_F(QemuQmpClient, reportsErrorsThroughTheFuture)
+{
+    auto reply = qmp.execute("device_del", {{"id", "foo"}});
+
+    qmp.handle_output(
+        QString{"{\"error\": {\"class\": \"DeviceNotFound\", \"desc\": \"Device 'foo' not found\"}, \"id\": %1}\n"}
+            .arg(written(0)["id"].toInteger())
+            .toUtf8());
+
+    MP_EXPECT_THROW_THAT(reply.get(),
+                         std::runtime_error,
+                         mpt::match_what(AllOf(HasSubstr("device_del"), HasSubstr("Device 'foo' not found"))));
+}
+
+TEST_F(QemuQmpClient, dispatchesEveryEventInOrder)
+{
+    qmp.handle_output("{\"QMP\": {\"version\": {}, \"capabilities\": []}}\n"
+                      "{\"timestamp\": {}, \"event\": \"STOP\"}\n"
+                      "{\"timestamp\": {}, \"event\": \"MIGRATION\", \"data\": {\"status\": \"completed\"}}\n");
+
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0].first, "STOP");
+    EXPECT_EQ(events[1].first, "MIGRATION");
+    EXPECT_EQ(events[1].second["status"].toString(), "completed");
+}
+
+TEST_F(QemuQmpClient, buffersPartialMessages)
+{
+    qmp.handle_output("{\"timestamp\": {}, \"event\": \"DEVICE_");
+    EXPECT_THAT(events, IsEmpty());
+
+    qmp.handle_output("DELETED\", \"data\": {\"device\": \"foo\"}}\n{\"timestamp\"");
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].second["device"].toString(), "foo");
+
+    qmp.handle_output(": {}, \"event\": \"RESUME\"}");
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[1].first, "RESUME");
+}
+
+TEST_F(QemuQmpClient, ignoresRepliesItDidNotAskFor)
+{
+    auto reply = qmp.execute("cont");
+
+    qmp.handle_output("{\"return\": {}}\n{\"return\": {}, \"id\": 12345}\n");
+
+    EXPECT_EQ(reply.wait_for(0s), std::future_status::timeout);
+    EXPECT_THAT(events, IsEmpty());
+}
+
+TEST_F(QemuQmpClient, failsAbandonedCommands)
+{
+    auto reply = qmp.execute("savevm");
+
+    qmp.abandon_pending("QEMU exited");
+
+    MP_EXPECT_THROW_THAT(reply.get(), std::runtime_error, mpt::match_what(HasSubstr("QEMU exited")));
+}
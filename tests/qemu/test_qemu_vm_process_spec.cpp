@@ -49,6 +49,13 @@ struct TestQemuVMProcessSpec : public Test
          {"path/to/source",
           {"-virtfs", "local,security_model=passthrough,uid_map=1000:1000,gid_map=1000:1000,path=path/to/"
                       "target,mount_tag=m810e457178f448d9afffc9d950d726"}}}};
+    const mp::QemuVirtualMachine::MountArgs virtiofs_mount_args{
+        {"m1",
+         {"path/to/source",
+          {"-chardev",
+           "socket,id=m1,path=/path/to/vfs.sock",
+           "-device",
+           "vhost-user-fs-pci,id=m1,chardev=m1,tag=m1"}}}};
 };
 
 TEST_F(TestQemuVMProcessSpec, default_arguments_correct)
@@ -68,6 +75,8 @@ TEST_F(TestQemuVMProcessSpec, default_arguments_correct)
                                              "2",
                                              "-m",
                                              "3072M",
+                                             "-device",
+                                             "virtio-balloon-pci,id=balloon0,deflate-on-oom=on,free-page-reporting=on",
                                              "-qmp",
                                              "stdio",
                                              "-chardev",
@@ -82,6 +91,30 @@ TEST_F(TestQemuVMProcessSpec, default_arguments_correct)
                                              "path=path/to/target,mount_tag=m810e457178f448d9afffc9d950d726"}));
 }
 
+TEST_F(TestQemuVMProcessSpec, disk_profile_attaches_image_to_virtio_blk_on_iothread)
+{
+    auto io_uring_desc = desc;
+    io_uring_desc.disk_profile = "io_uring";
+
+    mp::QemuVMProcessSpec spec(io_uring_desc, platform_args, mount_args, std::nullopt);
+    const auto args = spec.arguments();
+
+    EXPECT_TRUE(args.contains("iothread,id=iothread0"));
+    EXPECT_TRUE(args.contains("file=/path/to/image,if=none,format=qcow2,discard=unmap,id=hda,cache=none,aio=io_uring"));
+    EXPECT_TRUE(args.contains("virtio-blk-pci,drive=hda,iothread=iothread0,num-queues=2"));
+    EXPECT_FALSE(args.contains("virtio-scsi-pci,id=scsi0"));
+}
+
+TEST_F(TestQemuVMProcessSpec, guest_agent_channel_added_when_socket_given)
+{
+    mp::QemuVMProcessSpec spec(desc, platform_args, mount_args, std::nullopt, "/path/to/qga.sock");
+
+    const auto args = spec.arguments();
+    EXPECT_TRUE(args.contains("socket,path=/path/to/qga.sock,server=on,wait=off,id=qga0"));
+    EXPECT_TRUE(args.contains("virtio-serial"));
+    EXPECT_TRUE(args.contains("virtserialport,chardev=qga0,name=org.qemu.guest_agent.0"));
+}
+
 TEST_F(TestQemuVMProcessSpec, resume_arguments_taken_from_resumedata)
 {
     const mp::QemuVMProcessSpec::ResumeData resume_data{"suspend_tag", "machine_type", false, {"-one", "-two"}};
@@ -103,6 +136,17 @@ TEST_F(TestQemuVMProcessSpec, resume_with_missing_machine_type_guesses_correctly
     EXPECT_EQ(spec.arguments(), QStringList({"-args", "-loadvm", "suspend_tag"}) << mount_args.begin()->second.second);
 }
 
+TEST_F(TestQemuVMProcessSpec, resume_from_state_file_migrates_in_instead_of_loading_snapshot)
+{
+    const mp::QemuVMProcessSpec::ResumeData resume_data{"suspend_tag", "machine_type", false, {"-one"}, true};
+
+    mp::QemuVMProcessSpec spec(desc, platform_args, mount_args, resume_data, {}, "/path/to/suspend.vmstate");
+
+    EXPECT_EQ(spec.arguments(),
+              QStringList({"-one", "-incoming", "defer", "-machine", "machine_type"})
+                  << mount_args.begin()->second.second);
+}
+
 TEST_F(TestQemuVMProcessSpec, ResumeFixesVmnetFormat)
 {
     const mp::QemuVMProcessSpec::ResumeData resume_data{
@@ -114,6 +158,48 @@ TEST_F(TestQemuVMProcessSpec, ResumeFixesVmnetFormat)
                                     << mount_args.begin()->second.second);
 }
 
+#ifdef MULTIPASS_PLATFORM_LINUX // memory profiles are Linux-only
+TEST_F(TestQemuVMProcessSpec, memory_profile_backs_guest_ram)
+{
+    auto prealloc_desc = desc;
+    prealloc_desc.memory_profile = "prealloc";
+
+    mp::QemuVMProcessSpec spec(prealloc_desc, platform_args, mount_args, std::nullopt);
+
+    const auto args = spec.arguments().join(' ').toStdString();
+    EXPECT_THAT(args,
+                HasSubstr("-m 3072M -object memory-backend-memfd,id=mem,size=3072M,prealloc=on -numa node,memdev=mem"));
+    EXPECT_THAT(args, Not(HasSubstr("virtio-balloon-pci"))); // preallocated memory is meant to stay
+}
+#endif
+
+TEST_F(TestQemuVMProcessSpec, virtiofs_mounts_share_guest_memory)
+{
+    mp::QemuVMProcessSpec spec(desc, platform_args, virtiofs_mount_args, std::nullopt);
+
+    const auto args = spec.arguments().join(' ');
+    EXPECT_THAT(args.toStdString(),
+                AllOf(HasSubstr("-object memory-backend-memfd,id=mem,size=3072M,share=on -numa node,memdev=mem"),
+                      HasSubstr("-device vhost-user-fs-pci,id=m1,chardev=m1,tag=m1")));
+}
+
+TEST_F(TestQemuVMProcessSpec, resume_leaves_virtiofs_mounts_out)
+{
+    const mp::QemuVMProcessSpec::ResumeData resume_data{"suspend_tag", "machine_type", false, {"-one"}};
+
+    mp::QemuVMProcessSpec spec(desc, platform_args, virtiofs_mount_args, resume_data);
+
+    EXPECT_EQ(spec.arguments(), QStringList({"-one", "-loadvm", "suspend_tag", "-machine", "machine_type"}));
+}
+
+TEST_F(TestQemuVMProcessSpec, apparmor_profile_includes_virtiofs_socket_instead_of_source)
+{
+    mp::QemuVMProcessSpec spec(desc, platform_args, virtiofs_mount_args, std::nullopt);
+
+    EXPECT_TRUE(spec.apparmor_profile().contains("/path/to/vfs.sock rw,"));
+    EXPECT_FALSE(spec.apparmor_profile().contains("path/to/source/** rwlk"));
+}
+
 TEST_F(TestQemuVMProcessSpec, apparmorProfileIncludesFileMountPerms)
 {
     mp::QemuVMProcessSpec spec(desc, platform_args, mount_args, std::nullopt);
@@ -137,6 +223,20 @@ TEST_F(TestQemuVMProcessSpec, apparmor_profile_includes_disk_images)
     EXPECT_TRUE(spec.apparmor_profile().contains("/path/to/cloud_init.iso rk,"));
 }
 
+TEST_F(TestQemuVMProcessSpec, apparmor_profile_includes_guest_agent_socket)
+{
+    mp::QemuVMProcessSpec spec(desc, platform_args, mount_args, std::nullopt, "/path/to/qga.sock");
+
+    EXPECT_TRUE(spec.apparmor_profile().contains("/path/to/qga.sock rw,"));
+}
+
+TEST_F(TestQemuVMProcessSpec, apparmor_profile_includes_suspend_state_file)
+{
+    mp::QemuVMProcessSpec spec(desc, platform_args, mount_args, std::nullopt, {}, "/path/to/suspend.vmstate");
+
+    EXPECT_TRUE(spec.apparmor_profile().contains("/path/to/suspend.vmstate{,.part} rw,"));
+}
+
 TEST_F(TestQemuVMProcessSpec, apparmor_profile_identifier)
 {
     mp::QemuVMProcessSpec spec(desc, platform_args, mount_args, std::nullopt);
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "tests/common.h"
+#include "tests/mock_process_factory.h"
+
+#include <src/platform/backends/qemu/virtiofsd_process_spec.h>
+
+#include <QStringList>
+
+namespace mp = multipass;
+namespace mpt = multipass::test;
+using namespace testing;
+
+struct TestVirtiofsdProcessSpec : public Test
+{
+    std::string tag{"mabcdef"};
+    mp::VirtiofsShare share{"/home/ubuntu/src", "/tmp/vfs-mabcdef.sock", {1000, 1001}, {2000, 2001}};
+};
+
+TEST_F(TestVirtiofsdProcessSpec, default_arguments_correct)
+{
+    mp::VirtiofsdProcessSpec spec{tag, share};
+
+    EXPECT_EQ(spec.arguments(),
+              QStringList({"--socket-path=/tmp/vfs-mabcdef.sock",
+                           "--shared-dir=/home/ubuntu/src",
+                           "--cache=auto",
+                           "--announce-submounts",
+                           "--translate-uid=map:1001:1000:1",
+                           "--translate-gid=map:2001:2000:1"}));
+}
+
+TEST_F(TestVirtiofsdProcessSpec, identifier_is_tag)
+{
+    mp::VirtiofsdProcessSpec spec{tag, share};
+
+    EXPECT_EQ(spec.identifier(), QString::fromStdString(tag));
+}
+
+TEST_F(TestVirtiofsdProcessSpec, apparmor_profile_allows_socket_and_shared_dir)
+{
+    mp::VirtiofsdProcessSpec spec{tag, share};
+
+    EXPECT_THAT(spec.apparmor_profile(),
+                AllOf(HasSubstr("/tmp/vfs-mabcdef.sock{,.pid} rwk,"), HasSubstr("/home/ubuntu/src/** rwlk,")));
+}
+
+TEST_F(TestVirtiofsdProcessSpec, recognizes_virtiofs_mount_arguments)
+{
+    EXPECT_TRUE(mp::is_virtiofs_mount(
+        {"-chardev", "socket,id=m1,path=/tmp/s.sock", "-device", "vhost-user-fs-pci,id=m1,chardev=m1,tag=m1"}));
+    EXPECT_FALSE(mp::is_virtiofs_mount({"-virtfs", "local,security_model=passthrough,path=/src,mount_tag=m1"}));
+}
+
+struct TestVirtiofsdAvailability : public Test
+{
+    void report_version(const QByteArray& output)
+    {
+        process_factory->register_callback([output](mpt::MockProcess* process) {
+            EXPECT_EQ(process->arguments(), QStringList{"--version"});
+            ON_CALL(*process, read_all_standard_output()).WillByDefault(Return(output));
+        });
+    }
+
+    std::unique_ptr<mpt::MockProcessFactory::Scope> process_factory{mpt::MockProcessFactory::Inject()};
+};
+
+TEST_F(TestVirtiofsdAvailability, accepts_versions_that_map_ids)
+{
+    report_version("virtiofsd 1.11.1\n");
+
+    EXPECT_NO_THROW(mp::check_virtiofsd_usable());
+}
+
+TEST_F(TestVirtiofsdAvailability, rejects_versions_that_cannot_map_ids)
+{
+    report_version("virtiofsd 1.10.1\n");
+
+    MP_EXPECT_THROW_THAT(mp::check_virtiofsd_usable(),
+                         std::runtime_error,
+                         mpt::match_what(AllOf(HasSubstr("1.10 is too old"), HasSubstr("1.11"))));
+}
+
+TEST_F(TestVirtiofsdAvailability, reports_missing_virtiofsd)
+{
+    process_factory->register_callback([](mpt::MockProcess* process) {
+        mp::ProcessState exit_state{std::nullopt, mp::ProcessState::Error{QProcess::FailedToStart, "not found"}};
+        ON_CALL(*process, execute(_)).WillByDefault(Return(exit_state));
+    });
+
+    MP_EXPECT_THROW_THAT(mp::check_virtiofsd_usable(),
+                         std::runtime_error,
+                         mpt::match_what(HasSubstr("virtiofsd is not installed")));
+}
@@ -124,6 +124,14 @@ struct StubVirtualMachine final : public multipass::VirtualMachine
     {
     }
 
+    void update_disk_profile(const std::string&) override
+    {
+    }
+
+    void update_memory_profile(const std::string&) override
+    {
+    }
+
     void add_network_interface(int, const std::string&, const NetworkInterface&) override
     {
     }
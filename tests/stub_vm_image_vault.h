@@ -40,6 +40,10 @@ struct StubVMImageVault final : public multipass::VMImageVault
     };
 
     void remove(const std::string&) override{};
+    VMImage clone(const std::string&, const std::string&, const multipass::Path&) override
+    {
+        return {dummy_image.name(), {}, {}, {}, {}, {}};
+    }
     bool has_record_for(const std::string&) override
     {
         return false;
@@ -39,12 +39,14 @@
 #include <multipass/vm_specs.h>
 
 #include <algorithm>
+#include <future>
 
 namespace mp = multipass;
 namespace mpl = multipass::logging;
 namespace mpt = multipass::test;
 using namespace testing;
 using St = mp::VirtualMachine::State;
+using namespace std::chrono_literals;
 
 namespace
 {
@@ -805,7 +807,7 @@ TEST_F(BaseVM, restoresSnapshotsWithExtraInterfaceDiff)
     EXPECT_CALL(snapshot, get_extra_interfaces).Times(3).WillRepeatedly(Return(original_specs.extra_interfaces));
 
     EXPECT_CALL(*mock_cloud_init_file_ops_injection.first,
-                update_cloud_init_with_new_extra_interfaces_and_new_id(_, _, _, _))
+                update_cloud_init_with_new_extra_interfaces_and_new_id(_, _, _, _, _))
         .Times(1);
 
     vm.restore_snapshot(snapshot_name, new_specs);
@@ -1240,6 +1242,18 @@ TEST_F(BaseVM, waitForCloudInitNoErrorsAndDoneDoesNotThrow)
     EXPECT_NO_THROW(vm.wait_for_cloud_init(timeout));
 }
 
+TEST_F(BaseVM, waitForCloudInitWaitsInsideTheGuest)
+{
+    vm.simulate_cloud_init();
+    EXPECT_CALL(vm, ensure_vm_is_running()).WillRepeatedly(Return());
+    EXPECT_CALL(vm,
+                ssh_exec(AllOf(StartsWith("timeout 4 "), HasSubstr("until [ -e /var/lib/cloud/instance/boot-finished ]")),
+                         _))
+        .WillOnce(Return(""));
+
+    EXPECT_NO_THROW(vm.wait_for_cloud_init(std::chrono::minutes(5)));
+}
+
 TEST_F(BaseVM, waitForCloudInitErrorTimesOutThrows)
 {
     vm.simulate_cloud_init();
@@ -1384,4 +1398,27 @@ TEST_F(BaseVM, sshExecRethrowsSSHExceptionsWhenConnected)
     MP_EXPECT_THROW_THAT(vm.ssh_exec(cmd), mp::SSHException, mpt::match_what(HasSubstr("intentional")));
 }
 
+TEST_F(BaseVM, sshExecRunsConcurrentCommandsOnSeparateSessions)
+{
+    auto [mock_utils_ptr, guard] = mpt::MockUtils::inject();
+    EXPECT_CALL(*mock_utils_ptr, is_running).WillRepeatedly(Return(true));
+
+    std::promise<void> second_ran;
+    auto second_ran_future = second_ran.get_future();
+    EXPECT_CALL(*mock_utils_ptr, run_in_ssh_session(_, "first", _)).WillOnce(WithoutArgs([&second_ran_future] {
+        EXPECT_EQ(second_ran_future.wait_for(5s), std::future_status::ready);
+        return std::string{};
+    }));
+    EXPECT_CALL(*mock_utils_ptr, run_in_ssh_session(_, "second", _)).WillOnce(WithoutArgs([&second_ran] {
+        second_ran.set_value();
+        return std::string{};
+    }));
+
+    vm.simulate_ssh_exec();
+    auto first = std::async(std::launch::async, [this] { return vm.ssh_exec("first"); });
+
+    EXPECT_NO_THROW(vm.ssh_exec("second"));
+    EXPECT_NO_THROW(first.get());
+}
+
 } // namespace
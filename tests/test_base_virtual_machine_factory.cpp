@@ -16,8 +16,11 @@
  */
 
 #include "common.h"
+#include "file_operations.h"
+#include "mock_cloud_init_file_ops.h"
 #include "mock_logger.h"
 #include "mock_platform.h"
+#include "mock_settings.h"
 #include "stub_ssh_key_provider.h"
 #include "stub_url_downloader.h"
 #include "temp_dir.h"
@@ -106,6 +109,9 @@ TEST_F(BaseFactory, create_image_vault_returns_default_vault)
     std::vector<mp::VMImageHost*> hosts;
     MockBaseFactory factory;
 
+    auto [mock_settings, guard] = mpt::MockSettings::inject();
+    EXPECT_CALL(*mock_settings, get(Eq(mp::image_pool_key))).WillOnce(Return("0"));
+
     auto vault = factory.create_image_vault(hosts, &stub_downloader, cache_dir.path(), data_dir.path(), mp::days{0});
 
     EXPECT_TRUE(dynamic_cast<mp::DefaultVMImageVault*>(vault.get()));
@@ -151,6 +157,36 @@ TEST_F(BaseFactory, creates_cloud_init_iso_image)
     EXPECT_TRUE(QFile::exists(vm_desc.cloud_init_iso));
 }
 
+TEST_F(BaseFactory, prepareCloneCopiesCloudInitIsoAndRenewsIdentity)
+{
+    MockBaseFactory factory;
+    const QDir source_dir{factory.get_instance_directory("foo")};
+    const QDir clone_dir{factory.get_instance_directory("bar")};
+    ASSERT_TRUE(source_dir.mkpath(".") && clone_dir.mkpath("."));
+    mpt::make_file_with_content(source_dir.filePath("cloud-init-config.iso"), "iso");
+
+    mp::VirtualMachineDescription vm_desc{};
+    vm_desc.vm_name = "bar";
+    vm_desc.default_mac_address = "52:54:00:56:78:90";
+    vm_desc.extra_interfaces = {{"eth1", "52:54:00:56:78:91", true}};
+    vm_desc.image.image_path = clone_dir.filePath("image.img");
+
+    const auto expected_iso = clone_dir.filePath("cloud-init-config.iso");
+    const std::filesystem::path expected_iso_path{expected_iso.toStdString()};
+    auto [mock_cloud_init_file_ops, guard] = mpt::MockCloudInitFileOps::inject();
+    EXPECT_CALL(*mock_cloud_init_file_ops,
+                update_cloud_init_with_new_extra_interfaces_and_new_id(vm_desc.default_mac_address,
+                                                                       vm_desc.extra_interfaces,
+                                                                       "bar",
+                                                                       "bar",
+                                                                       expected_iso_path));
+
+    factory.prepare_clone("foo", vm_desc);
+
+    EXPECT_EQ(vm_desc.cloud_init_iso, expected_iso);
+    EXPECT_TRUE(QFile::exists(expected_iso));
+}
+
 TEST_F(BaseFactory, create_bridge_not_implemented)
 {
     StrictMock<MockBaseFactory> factory;
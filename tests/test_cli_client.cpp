@@ -101,6 +101,9 @@ struct MockDaemonRpc : public mp::DaemonRpc
                 (grpc::ServerContext * context,
                  (grpc::ServerReaderWriter<mp::SSHInfoReply, mp::SSHInfoRequest> * server)),
                 (override));
+    MOCK_METHOD(grpc::Status, exec,
+                (grpc::ServerContext * context, (grpc::ServerReaderWriter<mp::ExecReply, mp::ExecRequest> * server)),
+                (override));
     MOCK_METHOD(grpc::Status, start,
                 (grpc::ServerContext * context, (grpc::ServerReaderWriter<mp::StartReply, mp::StartRequest> * server)),
                 (override));
@@ -146,6 +149,11 @@ struct MockDaemonRpc : public mp::DaemonRpc
                 (grpc::ServerContext * context,
                  (grpc::ServerReaderWriter<mp::RestoreReply, mp::RestoreRequest> * server)),
                 (override));
+    MOCK_METHOD(grpc::Status,
+                clone,
+                (grpc::ServerContext * context,
+                 (grpc::ServerReaderWriter<mp::CloneReply, mp::CloneRequest> * server)),
+                (override));
 };
 
 struct Client : public Test
@@ -1271,6 +1279,85 @@ TEST_F(Client, launchCmdMountOptionFailsOnInvalidDir)
     EXPECT_THAT(err.str(), HasSubstr(fmt::format("Mount source path \"{}\" is not readable", fake_source)));
 }
 
+TEST_F(Client, launchCmdCountOptionRequestsSeveralInstances)
+{
+    const auto launch_matcher = AllOf(make_launch_instance_matcher("runner"),
+                                      Property(&mp::LaunchRequest::count, 3),
+                                      Property(&mp::LaunchRequest::parallelism, 2));
+
+    EXPECT_CALL(mock_daemon, launch)
+        .WillOnce(WithArg<1>(check_request_and_return<mp::LaunchReply, mp::LaunchRequest>(launch_matcher, ok)));
+    EXPECT_CALL(mock_daemon, mount).Times(0);
+    EXPECT_EQ(send_command({"launch", "--name", "runner", "--count", "3", "--parallel", "2"}), mp::ReturnCode::Ok);
+}
+
+TEST_F(Client, launchCmdCountOptionReportsEachLaunchedInstance)
+{
+    EXPECT_CALL(mock_daemon, launch)
+        .WillOnce([](auto, grpc::ServerReaderWriter<mp::LaunchReply, mp::LaunchRequest>* server) {
+            mp::LaunchReply reply;
+            for (const auto* name : {"runner-1", "runner-2"})
+            {
+                reply.set_vm_instance_name(name);
+                server->Write(reply);
+            }
+
+            return grpc::Status{};
+        });
+
+    std::stringstream out;
+    EXPECT_EQ(send_command({"launch", "--name", "runner", "--count", "2"}, out), mp::ReturnCode::Ok);
+    EXPECT_THAT(out.str(), AllOf(HasSubstr("Launched: runner-1\n"), HasSubstr("Launched: runner-2\n")));
+}
+
+TEST_F(ClientAlias, launchCmdCountOptionCreatesAliasesOfEachInstance)
+{
+    EXPECT_CALL(mock_daemon, launch)
+        .WillOnce([](auto, grpc::ServerReaderWriter<mp::LaunchReply, mp::LaunchRequest>* server) {
+            for (const auto* name : {"runner-1", "runner-2"})
+            {
+                mp::LaunchReply reply;
+                reply.set_vm_instance_name(name);
+
+                auto alias = reply.add_aliases_to_be_created();
+                alias->set_name("lsr");
+                alias->set_instance(name);
+                alias->set_command("ls");
+                alias->set_working_directory("map");
+
+                server->Write(reply);
+            }
+
+            return grpc::Status{};
+        });
+
+    EXPECT_EQ(send_command({"launch", "--name", "runner", "--count", "2"}), mp::ReturnCode::Ok);
+
+    std::stringstream cout_stream;
+    send_command({"aliases", "--format=csv"}, cout_stream);
+
+    EXPECT_THAT(cout_stream.str(), AllOf(HasSubstr("lsr,runner-1,ls,map,"), HasSubstr("lsr,runner-2,ls,map,")));
+}
+
+TEST_F(Client, launchCmdCountOptionFailsOnInvalidValue)
+{
+    for (const auto* value : {"0", "-2", "two"})
+        EXPECT_EQ(send_command({"launch", "--count", value}), mp::ReturnCode::CommandLineError);
+
+    EXPECT_EQ(send_command({"launch", "--count", "2", "--parallel", "0"}), mp::ReturnCode::CommandLineError);
+}
+
+TEST_F(Client, launchCmdCountOptionRejectsMounts)
+{
+    const QTemporaryDir fake_directory{};
+
+    std::stringstream err;
+    EXPECT_EQ(
+        send_command({"launch", "--count", "2", "--mount", fake_directory.path().toStdString()}, trash_stream, err),
+        mp::ReturnCode::CommandLineError);
+    EXPECT_THAT(err.str(), HasSubstr("several instances"));
+}
+
 TEST_F(Client, launch_cmd_petenv_mount_option_override_home)
 {
     const QTemporaryDir fake_directory{};
@@ -1697,6 +1784,81 @@ TEST_F(Client, execFailsOnArgumentClash)
     EXPECT_THAT(cerr_stream.str(), Eq("Options --working-directory and --no-map-working-directory clash\n"));
 }
 
+TEST_F(Client, execSharedSessionRelaysOutputAndExitCode)
+{
+    std::string instance_name{"instance"};
+
+    EXPECT_CALL(mock_daemon, exec(_, _))
+        .WillOnce([&instance_name](grpc::ServerContext*,
+                                   grpc::ServerReaderWriter<mp::ExecReply, mp::ExecRequest>* server) {
+            mp::ExecRequest request;
+            server->Read(&request);
+            EXPECT_EQ(request.instance_name(), instance_name);
+            EXPECT_THAT(request.command(), StartsWith("cd "));
+            EXPECT_THAT(request.command(), HasSubstr("&&"));
+            EXPECT_THAT(request.command(), EndsWith("pwd"));
+
+            mp::ExecReply reply;
+            reply.set_std_out("some output");
+            reply.set_std_err("some error");
+            reply.set_exit_code(1);
+            server->Write(reply);
+            return grpc::Status{};
+        });
+    EXPECT_CALL(mock_daemon, ssh_info).Times(0);
+
+    std::stringstream cout_stream, cerr_stream;
+    EXPECT_EQ(send_command({"exec", instance_name, "--working-directory", "/home/ubuntu", "--shared-session", "--",
+                            "pwd"},
+                           cout_stream, cerr_stream),
+              mp::ReturnCode::CommandFail);
+    EXPECT_EQ(cout_stream.str(), "some output");
+    EXPECT_EQ(cerr_stream.str(), "some error");
+}
+
+TEST_F(Client, execSharedSessionRelaysOutputInChunks)
+{
+    EXPECT_CALL(mock_daemon, exec(_, _))
+        .WillOnce([](grpc::ServerContext*, grpc::ServerReaderWriter<mp::ExecReply, mp::ExecRequest>* server) {
+            mp::ExecReply reply;
+            reply.set_std_out("first ");
+            server->Write(reply);
+
+            reply.set_std_out("second");
+            reply.set_std_err("error");
+            server->Write(reply);
+
+            mp::ExecReply last_reply;
+            last_reply.set_exit_code(0);
+            server->Write(last_reply);
+            return grpc::Status{};
+        });
+
+    std::stringstream cout_stream, cerr_stream;
+    EXPECT_EQ(send_command({"exec", "instance", "--no-map-working-directory", "--shared-session", "--", "cmd"},
+                           cout_stream,
+                           cerr_stream),
+              mp::ReturnCode::Ok);
+    EXPECT_EQ(cout_stream.str(), "first second");
+    EXPECT_EQ(cerr_stream.str(), "error");
+}
+
+TEST_F(Client, execSharedSessionStartsInstanceIfStopped)
+{
+    const auto instance = "ordinary";
+    const auto start_matcher = make_instance_in_repeated_field_matcher<mp::StartRequest, 1>(instance);
+    const grpc::Status aborted{grpc::StatusCode::ABORTED, "msg"};
+
+    InSequence seq;
+    EXPECT_CALL(mock_daemon, exec).WillOnce(Return(aborted));
+    EXPECT_CALL(mock_daemon, start)
+        .WillOnce(WithArg<1>(check_request_and_return<mp::StartReply, mp::StartRequest>(start_matcher, ok)));
+    EXPECT_CALL(mock_daemon, exec).WillOnce(Return(ok));
+
+    EXPECT_THAT(send_command({"exec", instance, "--no-map-working-directory", "--shared-session", "--", "command"}),
+                Eq(mp::ReturnCode::Ok));
+}
+
 // help cli tests
 TEST_F(Client, help_cmd_ok_with_valid_single_arg)
 {
@@ -3323,6 +3485,80 @@ TEST_F(RestoreCommandClient, restoreCmdNotDestructiveNotLiveTermFails)
     EXPECT_THROW(setup_client_and_run({"restore", "foo.snapshot1"}, mock_terminal), std::runtime_error);
 }
 
+// clone cli tests
+TEST_F(Client, cloneCmdHelpOk)
+{
+    EXPECT_EQ(send_command({"clone", "--help"}), mp::ReturnCode::Ok);
+}
+
+TEST_F(Client, cloneCmdNoOptionsOk)
+{
+    EXPECT_CALL(mock_daemon, clone(_, _)).WillOnce([](auto, auto* server) {
+        mp::CloneRequest request;
+        server->Read(&request);
+
+        EXPECT_EQ(request.source_name(), "foo");
+        EXPECT_TRUE(request.destination_name().empty());
+        return grpc::Status{};
+    });
+
+    EXPECT_EQ(send_command({"clone", "foo"}), mp::ReturnCode::Ok);
+}
+
+TEST_F(Client, cloneCmdNameAlternativesOk)
+{
+    EXPECT_CALL(mock_daemon, clone(_, _)).Times(2).WillRepeatedly([](auto, auto* server) {
+        mp::CloneRequest request;
+        server->Read(&request);
+
+        EXPECT_EQ(request.destination_name(), "bar");
+        return grpc::Status{};
+    });
+
+    EXPECT_EQ(send_command({"clone", "-n", "bar", "foo"}), mp::ReturnCode::Ok);
+    EXPECT_EQ(send_command({"clone", "--name", "bar", "foo"}), mp::ReturnCode::Ok);
+}
+
+TEST_F(Client, cloneCmdReportsDestination)
+{
+    EXPECT_CALL(mock_daemon, clone(_, _)).WillOnce([](auto, auto* server) {
+        mp::CloneReply reply;
+        reply.set_destination_name("foo-clone1");
+        server->Write(reply);
+        return grpc::Status{};
+    });
+
+    std::stringstream cout_stream;
+    EXPECT_EQ(send_command({"clone", "foo"}, cout_stream), mp::ReturnCode::Ok);
+    EXPECT_THAT(cout_stream.str(), HasSubstr("Cloned from foo to foo-clone1."));
+}
+
+TEST_F(Client, cloneCmdNameConsumesArg)
+{
+    EXPECT_CALL(mock_daemon, clone).Times(0);
+    EXPECT_EQ(send_command({"clone", "--name", "foo"}), mp::ReturnCode::CommandLineError);
+    EXPECT_EQ(send_command({"clone", "-n", "foo"}), mp::ReturnCode::CommandLineError);
+}
+
+TEST_F(Client, cloneCmdTooFewArgsFails)
+{
+    EXPECT_EQ(send_command({"clone"}), mp::ReturnCode::CommandLineError);
+}
+
+TEST_F(Client, cloneCmdTooManyArgsFails)
+{
+    EXPECT_EQ(send_command({"clone", "foo", "bar"}), mp::ReturnCode::CommandLineError);
+}
+
+TEST_F(Client, cloneCmdFailsOnDaemonError)
+{
+    EXPECT_CALL(mock_daemon, clone).WillOnce(Return(grpc::Status{grpc::StatusCode::INVALID_ARGUMENT, "msg"}));
+
+    std::stringstream cerr_stream;
+    EXPECT_EQ(send_command({"clone", "foo"}, trash_stream, cerr_stream), mp::ReturnCode::CommandFail);
+    EXPECT_THAT(cerr_stream.str(), HasSubstr("msg"));
+}
+
 // authenticate cli tests
 TEST_F(Client, authenticateCmdGoodPassphraseOk)
 {
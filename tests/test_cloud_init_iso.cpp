@@ -376,6 +376,7 @@ TEST_F(CloudInitIso, updateCloudInitWithNewNonEmptyExtraInterfaces)
         MP_CLOUD_INIT_FILE_OPS.update_cloud_init_with_new_extra_interfaces_and_new_id(default_mac_addr,
                                                                                       extra_interfaces,
                                                                                       "vm2",
+                                                                                      "",
                                                                                       iso_path.toStdString()));
 
     constexpr std::string_view expected_modified_meta_data_content = R"(#cloud-config
@@ -418,12 +419,37 @@ TEST_F(CloudInitIso, updateCloudInitWithNewEmptyExtraInterfaces)
         MP_CLOUD_INIT_FILE_OPS.update_cloud_init_with_new_extra_interfaces_and_new_id(default_mac_addr,
                                                                                       empty_extra_interfaces,
                                                                                       std::string(),
+                                                                                      std::string(),
                                                                                       iso_path.toStdString()));
     mp::CloudInitIso new_iso;
     new_iso.read_from(iso_path.toStdString());
     EXPECT_FALSE(new_iso.contains("network-config"));
 }
 
+TEST_F(CloudInitIso, updateCloudInitWithNewHostname)
+{
+    mp::CloudInitIso original_iso;
+    original_iso.add_file("meta-data", std::string(meta_data_content));
+    original_iso.write_to(iso_path);
+
+    EXPECT_NO_THROW(
+        MP_CLOUD_INIT_FILE_OPS.update_cloud_init_with_new_extra_interfaces_and_new_id("52:54:00:56:78:90",
+                                                                                      {},
+                                                                                      "vm2",
+                                                                                      "vm2",
+                                                                                      iso_path.toStdString()));
+
+    constexpr std::string_view expected_modified_meta_data_content = R"(#cloud-config
+instance-id: vm2
+local-hostname: vm2
+cloud-name: multipass
+)";
+
+    mp::CloudInitIso new_iso;
+    new_iso.read_from(iso_path.toStdString());
+    EXPECT_EQ(new_iso.at("meta-data"), expected_modified_meta_data_content);
+}
+
 TEST_F(CloudInitIso, addExtraInterfaceToCloudInit)
 {
     mp::CloudInitIso original_iso;
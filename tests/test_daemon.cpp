@@ -41,6 +41,7 @@
 #include "tracking_url_downloader.h"
 
 #include <src/daemon/default_vm_image_vault.h>
+#include <src/daemon/instance_journal.h>
 #include <src/daemon/instance_settings_handler.h>
 
 #include <multipass/constants.h>
@@ -57,11 +58,13 @@
 #include <scope_guard.hpp>
 
 #include <QJsonArray>
+#include <QEventLoop>
 #include <QJsonDocument>
 #include <QNetworkProxyFactory>
 #include <QStorageInfo>
 #include <QString>
 #include <QSysInfo>
+#include <QTimer>
 
 #include <memory>
 #include <ostream>
@@ -160,6 +163,9 @@ TEST_F(Daemon, receives_commands_and_calls_corresponding_slot)
         .WillOnce(Invoke(&daemon, &mpt::MockDaemon::set_promise_value<mp::FindRequest, mp::FindReply>));
     EXPECT_CALL(daemon, ssh_info(_, _, _))
         .WillOnce(Invoke(&daemon, &mpt::MockDaemon::set_promise_value<mp::SSHInfoRequest, mp::SSHInfoReply>));
+    EXPECT_CALL(daemon, exec(_, _, _, _))
+        .WillOnce(WithArgs<0, 1, 2>(
+            Invoke(&daemon, &mpt::MockDaemon::set_promise_value<mp::ExecRequest, mp::ExecReply>)));
     EXPECT_CALL(daemon, info(_, _, _))
         .WillOnce(Invoke(&daemon, &mpt::MockDaemon::set_promise_value<mp::InfoRequest, mp::InfoReply>));
     EXPECT_CALL(daemon, list(_, _, _)).WillOnce([](auto, auto server, auto status_promise) {
@@ -195,6 +201,8 @@ TEST_F(Daemon, receives_commands_and_calls_corresponding_slot)
         .WillOnce(Invoke(&daemon, &mpt::MockDaemon::set_promise_value<mp::SnapshotRequest, mp::SnapshotReply>));
     EXPECT_CALL(daemon, restore)
         .WillOnce(Invoke(&daemon, &mpt::MockDaemon::set_promise_value<mp::RestoreRequest, mp::RestoreReply>));
+    EXPECT_CALL(daemon, clone)
+        .WillOnce(Invoke(&daemon, &mpt::MockDaemon::set_promise_value<mp::CloneRequest, mp::CloneReply>));
 
     EXPECT_CALL(mock_settings, get(Eq("foo"))).WillRepeatedly(Return("bar"));
 
@@ -205,6 +213,7 @@ TEST_F(Daemon, receives_commands_and_calls_corresponding_slot)
                    {"launch", "foo"},
                    {"delete", "foo"},
                    {"exec", "foo", "--no-map-working-directory", "--", "cmd"},
+                   {"exec", "foo", "--no-map-working-directory", "--shared-session", "--", "cmd"},
                    {"info", "foo"},
                    {"list"},
                    {"purge"},
@@ -215,6 +224,7 @@ TEST_F(Daemon, receives_commands_and_calls_corresponding_slot)
                    {"suspend", "foo"},
                    {"restart", "foo"},
                    {"restore", "foo.bar"},
+                   {"clone", "foo"},
                    {"version"},
                    {"find", "something"},
                    {"mount", ".", "target"},
@@ -1453,6 +1463,94 @@ TEST_F(Daemon, reads_mac_addresses_from_json)
     check_interfaces_in_json(filename, mac_addr, extra_interfaces);
 }
 
+TEST_F(Daemon, launchesSeveralInstancesWhenCountIsGiven)
+{
+    auto mock_factory = use_a_mock_vm_factory();
+    EXPECT_CALL(*mock_factory,
+                create_virtual_machine(Field(&mp::VirtualMachineDescription::vm_name, StartsWith("runner-")), _, _))
+        .Times(3);
+
+    mp::Daemon daemon{config_builder.build()};
+
+    std::stringstream cout_stream;
+    send_command({"launch", "--name", "runner", "--count", "3", "--parallel", "2"}, cout_stream);
+    EXPECT_THAT(cout_stream.str(),
+                AllOf(HasSubstr("Launched: runner-1\n"),
+                      HasSubstr("Launched: runner-2\n"),
+                      HasSubstr("Launched: runner-3\n")));
+}
+
+TEST_F(Daemon, refusesCountLaunchWhenNumberedNamesAreTaken)
+{
+    auto mock_factory = use_a_mock_vm_factory();
+    EXPECT_CALL(*mock_factory, create_virtual_machine).Times(1);
+
+    mp::Daemon daemon{config_builder.build()};
+    send_command({"launch", "--name", "runner-2"});
+
+    std::stringstream cerr_stream;
+    send_command({"launch", "--name", "runner", "--count", "3"}, trash_stream, cerr_stream);
+    EXPECT_THAT(cerr_stream.str(), HasSubstr("Instance names already in use: runner-2"));
+}
+
+TEST_F(Daemon, coalescesStateChangesIntoSingleDelayedJournalEntry)
+{
+    config_builder.vault = std::make_unique<NiceMock<mpt::MockVMImageVault>>();
+
+    const auto [temp_dir, filename] = plant_instance_json(fake_json_contents("52:54:00:73:76:28", {}));
+    EXPECT_CALL(*use_a_mock_vm_factory(), create_virtual_machine).WillRepeatedly(WithArg<0>([](const auto& desc) {
+        return std::make_unique<mpt::StubVirtualMachine>(desc.vm_name);
+    }));
+
+    const auto journal_filename = temp_dir->path() + "/multipassd-vm-instances.journal";
+    const auto original_records = QJsonDocument::fromJson(mpt::load(filename)).object();
+
+    config_builder.data_directory = temp_dir->path();
+    mp::Daemon daemon{config_builder.build()};
+    mp::VMStatusMonitor& monitor = daemon;
+
+    monitor.persist_state_for("real-zebraphant", mp::VirtualMachine::State::starting);
+    monitor.persist_state_for("real-zebraphant", mp::VirtualMachine::State::running);
+    EXPECT_FALSE(QFile::exists(journal_filename)); // nothing written yet
+
+    QEventLoop loop;
+    QTimer::singleShot(std::chrono::seconds(1), &loop, &QEventLoop::quit);
+    loop.exec();
+
+    ASSERT_TRUE(QFile::exists(journal_filename));
+    EXPECT_EQ(QJsonDocument::fromJson(mpt::load(filename)).object(), original_records); // database not rewritten
+
+    mp::InstanceJournal journal{journal_filename};
+    const auto records = journal.replay(original_records);
+    EXPECT_EQ(journal.size(), 1);
+    EXPECT_EQ(records["real-zebraphant"].toObject()["state"].toInt(),
+              static_cast<int>(mp::VirtualMachine::State::running));
+}
+
+TEST_F(Daemon, flushesPendingStateChangesOnDestruction)
+{
+    config_builder.vault = std::make_unique<NiceMock<mpt::MockVMImageVault>>();
+
+    const auto [temp_dir, filename] = plant_instance_json(fake_json_contents("52:54:00:73:76:28", {}));
+    EXPECT_CALL(*use_a_mock_vm_factory(), create_virtual_machine).WillRepeatedly(WithArg<0>([](const auto& desc) {
+        return std::make_unique<mpt::StubVirtualMachine>(desc.vm_name);
+    }));
+
+    config_builder.data_directory = temp_dir->path();
+    {
+        mp::Daemon daemon{config_builder.build()};
+        mp::VMStatusMonitor& monitor = daemon;
+
+        QFile::remove(filename);
+        monitor.persist_state_for("real-zebraphant", mp::VirtualMachine::State::suspended);
+    }
+
+    ASSERT_TRUE(QFile::exists(filename));
+    const auto records = QJsonDocument::fromJson(mpt::load(filename)).object();
+    EXPECT_EQ(records["real-zebraphant"].toObject()["state"].toInt(),
+              static_cast<int>(mp::VirtualMachine::State::suspended));
+}
+
 TEST_F(Daemon, writesAndReadsMountsInJson)
 {
     ON_CALL(mock_utils, make_dir(_, _, _))
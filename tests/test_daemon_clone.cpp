@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "daemon_test_fixture.h"
+#include "mock_platform.h"
+#include "mock_server_reader_writer.h"
+#include "mock_settings.h"
+#include "mock_virtual_machine.h"
+#include "mock_vm_image_vault.h"
+
+#include <multipass/exceptions/not_implemented_on_this_backend_exception.h>
+#include <multipass/virtual_machine_description.h>
+
+namespace mp = multipass;
+namespace mpt = multipass::test;
+
+using namespace testing;
+
+namespace
+{
+struct TestDaemonClone : public mpt::DaemonTestFixture
+{
+    void SetUp() override
+    {
+        EXPECT_CALL(mock_settings, register_handler).WillRepeatedly(Return(nullptr));
+        EXPECT_CALL(mock_settings, unregister_handler).Times(AnyNumber());
+
+        auto vault = std::make_unique<NiceMock<mpt::MockVMImageVault>>();
+        mock_vault = vault.get();
+        config_builder.vault = std::move(vault);
+    }
+
+    auto build_daemon_with_mock_instance()
+    {
+        const auto [temp_dir, filename] = plant_instance_json(fake_json_contents(mac_addr, extra_interfaces));
+
+        auto instance_ptr = std::make_unique<NiceMock<mpt::MockVirtualMachine>>(mock_instance_name);
+        auto* ret_instance = instance_ptr.get();
+
+        EXPECT_CALL(*instance_ptr, current_state).WillRepeatedly(Return(mp::VirtualMachine::State::stopped));
+        EXPECT_CALL(mock_factory, create_virtual_machine).WillOnce(Return(std::move(instance_ptr)));
+
+        config_builder.data_directory = temp_dir->path();
+        auto daemon = std::make_unique<mp::Daemon>(config_builder.build());
+
+        return std::pair{std::move(daemon), ret_instance};
+    }
+
+    using MockServer = StrictMock<mpt::MockServerReaderWriter<mp::CloneReply, mp::CloneRequest>>;
+
+    mpt::MockPlatform::GuardedMock mock_platform_injection{mpt::MockPlatform::inject<NiceMock>()};
+    mpt::MockPlatform& mock_platform = *mock_platform_injection.first;
+
+    mpt::MockSettings::GuardedMock mock_settings_injection = mpt::MockSettings::inject<StrictMock>();
+    mpt::MockSettings& mock_settings = *mock_settings_injection.first;
+
+    mpt::MockVirtualMachineFactory& mock_factory = *use_a_mock_vm_factory();
+    mpt::MockVMImageVault* mock_vault = nullptr;
+
+    std::vector<mp::NetworkInterface> extra_interfaces{{"eth1", "52:54:00:73:76:29", true}};
+    const std::string mac_addr{"52:54:00:73:76:28"};
+    const std::string mock_instance_name{"real-zebraphant"};
+};
+
+TEST_F(TestDaemonClone, failsOnMissingSource)
+{
+    mp::CloneRequest request{};
+    request.set_source_name("foo");
+
+    mp::Daemon daemon{config_builder.build()};
+    auto status = call_daemon_slot(daemon, &mp::Daemon::clone, request, MockServer{});
+
+    EXPECT_EQ(status.error_code(), grpc::StatusCode::NOT_FOUND);
+    EXPECT_EQ(status.error_message(), "instance \"foo\" does not exist");
+}
+
+TEST_F(TestDaemonClone, failsOnActiveSource)
+{
+    mp::CloneRequest request{};
+    request.set_source_name(mock_instance_name);
+
+    auto [daemon, instance] = build_daemon_with_mock_instance();
+    EXPECT_CALL(*instance, current_state).WillRepeatedly(Return(mp::VirtualMachine::State::running));
+    EXPECT_CALL(*mock_vault, clone).Times(0);
+
+    auto status = call_daemon_slot(*daemon, &mp::Daemon::clone, request, MockServer{});
+
+    EXPECT_EQ(status.error_code(), grpc::INVALID_ARGUMENT);
+    EXPECT_THAT(status.error_message(), HasSubstr("stopped"));
+}
+
+TEST_F(TestDaemonClone, failsOnSourceWithSnapshots)
+{
+    mp::CloneRequest request{};
+    request.set_source_name(mock_instance_name);
+
+    auto [daemon, instance] = build_daemon_with_mock_instance();
+    EXPECT_CALL(*instance, get_num_snapshots).WillRepeatedly(Return(2));
+    EXPECT_CALL(*mock_vault, clone).Times(0);
+
+    auto status = call_daemon_slot(*daemon, &mp::Daemon::clone, request, MockServer{});
+
+    EXPECT_EQ(status.error_code(), grpc::INVALID_ARGUMENT);
+    EXPECT_THAT(status.error_message(), HasSubstr("snapshots"));
+}
+
+TEST_F(TestDaemonClone, failsOnInvalidDestinationName)
+{
+    mp::CloneRequest request{};
+    request.set_source_name(mock_instance_name);
+    request.set_destination_name("no_underscores.or.dots");
+
+    auto [daemon, instance] = build_daemon_with_mock_instance();
+    auto status = call_daemon_slot(*daemon, &mp::Daemon::clone, request, MockServer{});
+
+    EXPECT_EQ(status.error_code(), grpc::INVALID_ARGUMENT);
+    EXPECT_THAT(status.error_message(), HasSubstr("Invalid instance name"));
+}
+
+TEST_F(TestDaemonClone, failsOnExistingDestination)
+{
+    mp::CloneRequest request{};
+    request.set_source_name(mock_instance_name);
+    request.set_destination_name(mock_instance_name);
+
+    auto [daemon, instance] = build_daemon_with_mock_instance();
+    auto status = call_daemon_slot(*daemon, &mp::Daemon::clone, request, MockServer{});
+
+    EXPECT_EQ(status.error_code(), grpc::INVALID_ARGUMENT);
+    EXPECT_THAT(status.error_message(), HasSubstr("already exists"));
+}
+
+TEST_F(TestDaemonClone, clonesIntoGeneratedNameWithNewIdentity)
+{
+    const std::string clone_name{mock_instance_name + "-clone1"};
+    mp::CloneRequest request{};
+    request.set_source_name(mock_instance_name);
+
+    auto [daemon, instance] = build_daemon_with_mock_instance();
+
+    const mp::VMImage cloned_image{"/path/to/clone.img", "abcd", "", "", "", {}};
+    EXPECT_CALL(*mock_vault, clone(mock_instance_name, clone_name, _)).WillOnce(Return(cloned_image));
+    EXPECT_CALL(mock_factory, prepare_clone(mock_instance_name, _))
+        .WillOnce([this, &clone_name](auto&, mp::VirtualMachineDescription& desc) {
+            EXPECT_EQ(desc.vm_name, clone_name);
+            EXPECT_EQ(desc.image.image_path, "/path/to/clone.img");
+            EXPECT_NE(desc.default_mac_address, mac_addr);
+            ASSERT_EQ(desc.extra_interfaces.size(), extra_interfaces.size());
+            EXPECT_NE(desc.extra_interfaces[0].mac_address, extra_interfaces[0].mac_address);
+            EXPECT_EQ(desc.extra_interfaces[0].id, extra_interfaces[0].id);
+        });
+    EXPECT_CALL(mock_factory, create_virtual_machine(Field(&mp::VirtualMachineDescription::vm_name, clone_name), _, _))
+        .WillOnce(Return(std::make_unique<NiceMock<mpt::MockVirtualMachine>>(clone_name)));
+
+    MockServer server;
+    EXPECT_CALL(server, Write(Property(&mp::CloneReply::destination_name, Eq(clone_name)), _)).WillOnce(Return(true));
+
+    auto status = call_daemon_slot(*daemon, &mp::Daemon::clone, request, server);
+
+    EXPECT_EQ(status.error_code(), grpc::OK);
+}
+
+TEST_F(TestDaemonClone, releasesResourcesOnFailure)
+{
+    const std::string clone_name{"dolly"};
+    mp::CloneRequest request{};
+    request.set_source_name(mock_instance_name);
+    request.set_destination_name(clone_name);
+
+    auto [daemon, instance] = build_daemon_with_mock_instance();
+
+    EXPECT_CALL(mock_factory, prepare_clone).WillOnce(Throw(mp::NotImplementedOnThisBackendException{"clone"}));
+    EXPECT_CALL(*mock_vault, remove(clone_name));
+    EXPECT_CALL(mock_factory, remove_resources_for(clone_name));
+
+    auto status = call_daemon_slot(*daemon, &mp::Daemon::clone, request, MockServer{});
+
+    EXPECT_EQ(status.error_code(), grpc::FAILED_PRECONDITION);
+    EXPECT_THAT(status.error_message(), HasSubstr("clone"));
+}
+} // namespace
@@ -330,4 +330,95 @@ TEST_F(TestGlobalSettingsHandlers, daemonRegistersHandlerThatResetsHashWhenPassw
     ASSERT_NO_THROW(handler->set(mp::passphrase_key, val));
 }
 
+TEST_F(TestGlobalSettingsHandlers, daemonRegistersHandlerThatAcceptsFileSuspendMode)
+{
+    const auto val = "file";
+
+    mp::daemon::register_global_settings_handlers();
+
+    EXPECT_CALL(*mock_qsettings, setValue(Eq(mp::qemu_suspend_mode_key), Eq(val)));
+    inject_mock_qsettings();
+
+    ASSERT_NO_THROW(handler->set(mp::qemu_suspend_mode_key, val));
+}
+
+TEST_F(TestGlobalSettingsHandlers, daemonRegistersHandlerThatRejectsInvalidSuspendMode)
+{
+    const auto key = mp::qemu_suspend_mode_key, val = "hibernate";
+
+    mp::daemon::register_global_settings_handlers();
+
+    MP_ASSERT_THROW_THAT(handler->set(key, val),
+                         mp::InvalidSettingException,
+                         mpt::match_what(AllOf(HasSubstr(key), HasSubstr(val))));
+}
+
+TEST_F(TestGlobalSettingsHandlers, daemonRegistersHandlerThatAcceptsVirtiofsMountDriver)
+{
+    const auto val = "virtiofs";
+
+    mp::daemon::register_global_settings_handlers();
+
+    EXPECT_CALL(*mock_qsettings, setValue(Eq(mp::qemu_mount_driver_key), Eq(val)));
+    inject_mock_qsettings();
+
+    ASSERT_NO_THROW(handler->set(mp::qemu_mount_driver_key, val));
+}
+
+TEST_F(TestGlobalSettingsHandlers, daemonRegistersHandlerThatRejectsInvalidMountDriver)
+{
+    const auto key = mp::qemu_mount_driver_key, val = "sshfs";
+
+    mp::daemon::register_global_settings_handlers();
+
+    MP_ASSERT_THROW_THAT(handler->set(key, val),
+                         mp::InvalidSettingException,
+                         mpt::match_what(AllOf(HasSubstr(key), HasSubstr(val))));
+}
+
+TEST_F(TestGlobalSettingsHandlers, daemonRegistersHandlerThatAcceptsImagePoolSize)
+{
+    const auto val = "2";
+
+    mp::daemon::register_global_settings_handlers();
+
+    EXPECT_CALL(*mock_qsettings, setValue(Eq(mp::image_pool_key), Eq(val)));
+    inject_mock_qsettings();
+
+    ASSERT_NO_THROW(handler->set(mp::image_pool_key, val));
+}
+
+TEST_F(TestGlobalSettingsHandlers, daemonRegistersHandlerThatRejectsInvalidImagePoolSize)
+{
+    mp::daemon::register_global_settings_handlers();
+
+    for (const auto* val : {"-1", "two", ""})
+        MP_EXPECT_THROW_THAT(handler->set(mp::image_pool_key, val),
+                             mp::InvalidSettingException,
+                             mpt::match_what(HasSubstr(mp::image_pool_key)));
+}
+
+TEST_F(TestGlobalSettingsHandlers, daemonRegistersHandlerThatAcceptsPsiOvercommit)
+{
+    const auto val = "psi";
+
+    mp::daemon::register_global_settings_handlers();
+
+    EXPECT_CALL(*mock_qsettings, setValue(Eq(mp::qemu_overcommit_key), Eq(val)));
+    inject_mock_qsettings();
+
+    ASSERT_NO_THROW(handler->set(mp::qemu_overcommit_key, val));
+}
+
+TEST_F(TestGlobalSettingsHandlers, daemonRegistersHandlerThatRejectsInvalidOvercommit)
+{
+    const auto key = mp::qemu_overcommit_key, val = "always";
+
+    mp::daemon::register_global_settings_handlers();
+
+    MP_ASSERT_THROW_THAT(handler->set(key, val),
+                         mp::InvalidSettingException,
+                         mpt::match_what(AllOf(HasSubstr(key), HasSubstr(val))));
+}
+
 } // namespace
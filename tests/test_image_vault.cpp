@@ -40,6 +40,7 @@
 #include <multipass/utils.h>
 
 #include <QDateTime>
+#include <QFile>
 #include <QThread>
 #include <QUrl>
 
@@ -289,6 +290,83 @@ TEST_F(ImageVault, caches_prepared_images)
     EXPECT_THAT(vm_image1.id, Eq(vm_image2.id));
 }
 
+TEST_F(ImageVault, instanceImagesComeFromThePool)
+{
+    mp::DefaultVMImageVault vault{hosts, &url_downloader, cache_dir.path(), data_dir.path(), mp::days{0}, 2};
+    auto vm_image1 = vault.fetch_image(mp::FetchType::ImageOnly,
+                                       default_query,
+                                       stub_prepare,
+                                       stub_monitor,
+                                       false,
+                                       std::nullopt,
+                                       instance_dir);
+
+    // the pool is filled in the background
+    const QDir pool_dir{data_dir.filePath(QString{"vault/pools/%1"}.arg(QString::fromStdString(vm_image1.id)))};
+    auto pooled_images = [&pool_dir] { return QDir{pool_dir.path()}.entryList({"*.img"}, QDir::Files); };
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+    while (pooled_images().size() < 2 && std::chrono::steady_clock::now() < deadline)
+        QThread::msleep(10);
+
+    ASSERT_EQ(pooled_images().size(), 2);
+    for (const auto& pooled_image : pooled_images())
+        MP_UTILS.make_file_with_content(pool_dir.filePath(pooled_image).toStdString(), "pooled", true);
+
+    auto another_query = default_query;
+    another_query.name = "valley-pied-piper-chat";
+    auto vm_image2 = vault.fetch_image(mp::FetchType::ImageOnly,
+                                       another_query,
+                                       stub_prepare,
+                                       stub_monitor,
+                                       false,
+                                       std::nullopt,
+                                       save_dir.filePath(QString::fromStdString(another_query.name)));
+
+    EXPECT_EQ(QFileInfo{vm_image2.image_path}.fileName(), QFileInfo{vm_image1.image_path}.fileName());
+    EXPECT_EQ(mpt::load(vm_image2.image_path), "pooled");
+    EXPECT_EQ(vm_image2.id, vm_image1.id);
+}
+
+TEST_F(ImageVault, poolsOfUnknownImagesAreRemoved)
+{
+    const auto pooled_image = data_dir.filePath("vault/pools/gone/pooled.img");
+    mpt::make_file_with_content(pooled_image);
+
+    mp::DefaultVMImageVault vault{hosts, &url_downloader, cache_dir.path(), data_dir.path(), mp::days{0}, 2};
+    vault.prune_expired_images();
+
+    EXPECT_FALSE(QFileInfo::exists(QFileInfo{pooled_image}.path()));
+}
+
+TEST_F(ImageVault, leavesNoPartialPooledImagesBehindWhenDestroyedMidRefill)
+{
+    const auto file_name = QDir{cache_dir.path()}.filePath("prepared-image");
+    {
+        QFile file{file_name};
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+        ASSERT_TRUE(file.resize(64LL << 20)); // several chunks to copy, without taking up the space
+    }
+
+    auto prepare = [&file_name](const mp::VMImage& source_image) -> mp::VMImage {
+        return {file_name, source_image.id, "", "", "", {}};
+    };
+
+    QDir pool_dir;
+    {
+        mp::DefaultVMImageVault vault{hosts, &url_downloader, cache_dir.path(), data_dir.path(), mp::days{0}, 2};
+        const auto vm_image = vault.fetch_image(mp::FetchType::ImageOnly,
+                                                default_query,
+                                                prepare,
+                                                stub_monitor,
+                                                false,
+                                                std::nullopt,
+                                                instance_dir);
+        pool_dir.setPath(data_dir.filePath(QString{"vault/pools/%1"}.arg(QString::fromStdString(vm_image.id))));
+    }
+
+    EXPECT_THAT(pool_dir.entryList({"*.partial"}, QDir::Files), IsEmpty());
+}
+
 TEST_F(ImageVault, remembers_instance_images)
 {
     int prepare_called_count{0};
@@ -324,6 +402,59 @@ TEST_F(ImageVault, remembers_instance_images)
     EXPECT_THAT(vm_image1.image_path, Eq(vm_image2.image_path));
 }
 
+TEST_F(ImageVault, clonesInstanceImages)
+{
+    mp::DefaultVMImageVault vault{hosts, &url_downloader, cache_dir.path(), data_dir.path(), mp::days{0}};
+    auto source_image = vault.fetch_image(mp::FetchType::ImageOnly,
+                                          default_query,
+                                          stub_prepare,
+                                          stub_monitor,
+                                          false,
+                                          std::nullopt,
+                                          instance_dir);
+
+    const std::string clone_name{"valley-pied-piper-clone1"};
+    const auto clone_dir = save_dir.filePath(QString::fromStdString(clone_name));
+    auto cloned_image = vault.clone(instance_name, clone_name, clone_dir);
+
+    EXPECT_TRUE(vault.has_record_for(clone_name));
+    EXPECT_TRUE(cloned_image.image_path.startsWith(clone_dir));
+    EXPECT_TRUE(QFile::exists(cloned_image.image_path));
+    EXPECT_EQ(cloned_image.id, source_image.id);
+
+    mp::Query clone_query{default_query};
+    clone_query.name = clone_name;
+    auto fetched_clone = vault.fetch_image(mp::FetchType::ImageOnly,
+                                           clone_query,
+                                           stub_prepare,
+                                           stub_monitor,
+                                           false,
+                                           std::nullopt,
+                                           clone_dir);
+
+    EXPECT_EQ(fetched_clone.image_path, cloned_image.image_path);
+    EXPECT_THAT(url_downloader.downloaded_files.size(), Eq(1));
+}
+
+TEST_F(ImageVault, cloneThrowsOnUnknownSourceOrExistingDestination)
+{
+    mp::DefaultVMImageVault vault{hosts, &url_downloader, cache_dir.path(), data_dir.path(), mp::days{0}};
+    vault.fetch_image(mp::FetchType::ImageOnly,
+                      default_query,
+                      stub_prepare,
+                      stub_monitor,
+                      false,
+                      std::nullopt,
+                      instance_dir);
+
+    MP_EXPECT_THROW_THAT(vault.clone("nonexistent", "other", save_dir.filePath("other")),
+                         std::runtime_error,
+                         mpt::match_what(HasSubstr("No instance image found")));
+    MP_EXPECT_THROW_THAT(vault.clone(instance_name, instance_name, instance_dir),
+                         std::runtime_error,
+                         mpt::match_what(HasSubstr("already exists")));
+}
+
 TEST_F(ImageVault, remembers_prepared_images)
 {
     int prepare_called_count{0};
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "file_operations.h"
+#include "temp_dir.h"
+
+#include <src/daemon/instance_journal.h>
+
+#include <QFile>
+#include <QJsonObject>
+
+namespace mp = multipass;
+namespace mpt = multipass::test;
+using namespace testing;
+
+namespace
+{
+struct TestInstanceJournal : public Test
+{
+    QJsonObject record_with_state(int state)
+    {
+        return QJsonObject{{"num_cores", 2}, {"state", state}};
+    }
+
+    mpt::TempDir temp_dir;
+    QString journal_path = temp_dir.filePath("instances.journal");
+    QJsonObject base{{"foo", record_with_state(0)}, {"bar", record_with_state(0)}};
+};
+
+TEST_F(TestInstanceJournal, replayWithoutJournalReturnsBase)
+{
+    mp::InstanceJournal journal{journal_path};
+
+    EXPECT_EQ(journal.replay(base), base);
+    EXPECT_EQ(journal.size(), 0);
+}
+
+TEST_F(TestInstanceJournal, replayAppliesAppendedRecordsInOrder)
+{
+    {
+        mp::InstanceJournal journal{journal_path};
+        journal.replay(base);
+        ASSERT_TRUE(journal.append(QJsonObject{{"foo", record_with_state(1)}}));
+        ASSERT_TRUE(journal.append(QJsonObject{{"foo", record_with_state(2)}, {"baz", record_with_state(3)}}));
+        EXPECT_EQ(journal.size(), 2);
+    }
+
+    mp::InstanceJournal journal{journal_path};
+    const auto records = journal.replay(base);
+
+    EXPECT_EQ(journal.size(), 2);
+    EXPECT_EQ(records["foo"], record_with_state(2));
+    EXPECT_EQ(records["bar"], record_with_state(0));
+    EXPECT_EQ(records["baz"], record_with_state(3));
+}
+
+TEST_F(TestInstanceJournal, replayDiscardsJournalOfDifferentBase)
+{
+    {
+        mp::InstanceJournal journal{journal_path};
+        journal.replay(base);
+        ASSERT_TRUE(journal.append(QJsonObject{{"foo", record_with_state(1)}}));
+    }
+
+    const QJsonObject other_base{{"foo", record_with_state(4)}};
+    mp::InstanceJournal journal{journal_path};
+
+    EXPECT_EQ(journal.replay(other_base), other_base);
+    EXPECT_EQ(journal.size(), 0);
+    EXPECT_FALSE(QFile::exists(journal_path));
+}
+
+TEST_F(TestInstanceJournal, replayIgnoresTornTail)
+{
+    {
+        mp::InstanceJournal journal{journal_path};
+        journal.replay(base);
+        ASSERT_TRUE(journal.append(QJsonObject{{"foo", record_with_state(1)}}));
+    }
+
+    QFile file{journal_path};
+    ASSERT_TRUE(file.open(QIODevice::Append));
+    file.write(QByteArray{"\x00\x00\x01\x00garbage", 11});
+    file.close();
+
+    mp::InstanceJournal journal{journal_path};
+    const auto records = journal.replay(base);
+
+    EXPECT_EQ(journal.size(), 1);
+    EXPECT_EQ(records["foo"], record_with_state(1));
+}
+
+TEST_F(TestInstanceJournal, replayDiscardsCorruptFile)
+{
+    mpt::make_file_with_content(journal_path, "not a journal");
+    mp::InstanceJournal journal{journal_path};
+
+    EXPECT_EQ(journal.replay(base), base);
+    EXPECT_FALSE(QFile::exists(journal_path));
+}
+
+TEST_F(TestInstanceJournal, appendFailsWithoutBase)
+{
+    mp::InstanceJournal journal{journal_path};
+
+    EXPECT_FALSE(journal.append(QJsonObject{{"foo", record_with_state(1)}}));
+    EXPECT_FALSE(QFile::exists(journal_path));
+}
+
+TEST_F(TestInstanceJournal, resetStartsOverOnNewBase)
+{
+    mp::InstanceJournal journal{journal_path};
+    journal.replay(base);
+    ASSERT_TRUE(journal.append(QJsonObject{{"foo", record_with_state(1)}}));
+
+    auto new_base = base;
+    new_base["foo"] = record_with_state(1);
+    journal.reset(new_base);
+
+    EXPECT_EQ(journal.size(), 0);
+    EXPECT_FALSE(QFile::exists(journal_path));
+
+    ASSERT_TRUE(journal.append(QJsonObject{{"bar", record_with_state(5)}}));
+
+    mp::InstanceJournal reloaded{journal_path};
+    const auto records = reloaded.replay(new_base);
+    EXPECT_EQ(reloaded.size(), 1);
+    EXPECT_EQ(records["foo"], record_with_state(1));
+    EXPECT_EQ(records["bar"], record_with_state(5));
+}
+} // namespace
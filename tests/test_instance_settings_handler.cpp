@@ -141,7 +141,12 @@ struct TestInstanceSettingsHandler : public Test
     bool user_authorized = true;
     inline static constexpr std::array numeric_properties{"cpus", "disk", "memory"};
     inline static constexpr std::array boolean_properties{"bridged"};
-    inline static constexpr std::array properties{"cpus", "disk", "memory", "bridged"};
+    inline static constexpr std::array properties{"cpus",
+                                                  "disk",
+                                                  "memory",
+                                                  "bridged",
+                                                  "disk-profile",
+                                                  "memory-profile"};
 };
 
 QString make_key(const QString& instance_name, const QString& property)
@@ -553,6 +558,92 @@ TEST_F(TestInstanceSettingsHandler, setDoesNotAddTwoInterfaces)
     EXPECT_EQ(specs[target_instance_name].extra_interfaces.size(), 1u);
 }
 
+TEST_F(TestInstanceSettingsHandler, getFetchesInstanceDiskProfile)
+{
+    constexpr auto target_instance_name = "ella";
+    specs.insert({{"louis", {}}, {target_instance_name, {}}});
+    specs[target_instance_name].disk_profile = "io_uring";
+
+    EXPECT_EQ(make_handler().get(make_key(target_instance_name, "disk-profile")), "io_uring");
+    EXPECT_EQ(make_handler().get(make_key("louis", "disk-profile")), mp::default_disk_profile);
+}
+
+TEST_F(TestInstanceSettingsHandler, setUpdatesInstanceDiskProfile)
+{
+    constexpr auto target_instance_name = "nina";
+    const auto& actual_profile = specs[target_instance_name].disk_profile;
+
+    EXPECT_CALL(mock_vm(target_instance_name), update_disk_profile(Eq("native"))).Times(1);
+
+    make_handler().set(make_key(target_instance_name, "disk-profile"), "native");
+    EXPECT_EQ(actual_profile, "native");
+    EXPECT_TRUE(fake_persister_called);
+}
+
+TEST_F(TestInstanceSettingsHandler, setMaintainsInstanceDiskProfileUntouchedIfSameButSucceeds)
+{
+    constexpr auto target_instance_name = "billie";
+    specs[target_instance_name];
+
+    EXPECT_CALL(mock_vm(target_instance_name), update_disk_profile).Times(0);
+
+    EXPECT_NO_THROW(make_handler().set(make_key(target_instance_name, "disk-profile"), mp::default_disk_profile));
+}
+
+TEST_F(TestInstanceSettingsHandler, setRefusesDiskProfileUnknownToBackend)
+{
+    constexpr auto target_instance_name = "sarah";
+    constexpr auto bad_profile = "turbo";
+    const auto original_specs = specs[target_instance_name];
+
+    EXPECT_CALL(mock_vm(target_instance_name), update_disk_profile(Eq(bad_profile)))
+        .WillOnce(Throw(std::invalid_argument{"Unknown disk profile"}));
+
+    MP_EXPECT_THROW_THAT(make_handler().set(make_key(target_instance_name, "disk-profile"), bad_profile),
+                         mp::InvalidSettingException,
+                         mpt::match_what(AllOf(HasSubstr(bad_profile), HasSubstr("Unknown disk profile"))));
+
+    EXPECT_EQ(original_specs, specs[target_instance_name]);
+}
+
+TEST_F(TestInstanceSettingsHandler, getFetchesInstanceMemoryProfile)
+{
+    constexpr auto target_instance_name = "ada";
+    specs.insert({{"grace", {}}, {target_instance_name, {}}});
+    specs[target_instance_name].memory_profile = "hugepages,node=1";
+
+    EXPECT_EQ(make_handler().get(make_key(target_instance_name, "memory-profile")), "hugepages,node=1");
+    EXPECT_EQ(make_handler().get(make_key("grace", "memory-profile")), mp::default_memory_profile);
+}
+
+TEST_F(TestInstanceSettingsHandler, setUpdatesInstanceMemoryProfile)
+{
+    constexpr auto target_instance_name = "hedy";
+    const auto& actual_profile = specs[target_instance_name].memory_profile;
+
+    EXPECT_CALL(mock_vm(target_instance_name), update_memory_profile(Eq("prealloc"))).Times(1);
+
+    make_handler().set(make_key(target_instance_name, "memory-profile"), "prealloc");
+    EXPECT_EQ(actual_profile, "prealloc");
+    EXPECT_TRUE(fake_persister_called);
+}
+
+TEST_F(TestInstanceSettingsHandler, setRefusesMemoryProfileUnknownToBackend)
+{
+    constexpr auto target_instance_name = "radia";
+    constexpr auto bad_profile = "gigapages";
+    const auto original_specs = specs[target_instance_name];
+
+    EXPECT_CALL(mock_vm(target_instance_name), update_memory_profile(Eq(bad_profile)))
+        .WillOnce(Throw(std::invalid_argument{"Unknown memory profile"}));
+
+    MP_EXPECT_THROW_THAT(make_handler().set(make_key(target_instance_name, "memory-profile"), bad_profile),
+                         mp::InvalidSettingException,
+                         mpt::match_what(AllOf(HasSubstr(bad_profile), HasSubstr("Unknown memory profile"))));
+
+    EXPECT_EQ(original_specs, specs[target_instance_name]);
+}
+
 using VMSt = mp::VirtualMachine::State;
 using Property = const char*;
 using PropertyAndState = std::tuple<Property, VMSt>; // no subliminal political msg intended :)
@@ -60,6 +60,46 @@ TEST_F(SSHProcess, can_retrieve_exit_status)
     EXPECT_THAT(proc.exit_code(), Eq(expected_status));
 }
 
+TEST_F(SSHProcess, keepsOutputReceivedWhileWaitingForExitStatus)
+{
+    ssh_channel_callbacks callbacks{nullptr};
+    REPLACE(ssh_add_channel_callbacks, [&callbacks](ssh_channel, ssh_channel_callbacks cb) {
+        callbacks = cb;
+        return SSH_OK;
+    });
+
+    std::string out{"some output"}, err{"some error"};
+    REPLACE(ssh_event_dopoll, [&callbacks, &out, &err](auto...) {
+        EXPECT_THAT(callbacks->channel_data_function, NotNull());
+        callbacks->channel_data_function(nullptr, nullptr, out.data(), out.size(), 0, callbacks->userdata);
+        callbacks->channel_data_function(nullptr, nullptr, err.data(), err.size(), 1, callbacks->userdata);
+        callbacks->channel_exit_status_function(nullptr, nullptr, 0, callbacks->userdata);
+        return SSH_OK;
+    });
+    REPLACE(ssh_channel_read_timeout, [](auto...) { return 0; });
+
+    auto proc = session.exec("something");
+    EXPECT_EQ(proc.exit_code(), 0);
+    EXPECT_EQ(proc.read_std_output(), out);
+    EXPECT_EQ(proc.read_std_error(), err);
+}
+
+TEST_F(SSHProcess, leavesOutputInChannelWhenProbingForExit)
+{
+    ssh_channel_callbacks callbacks{nullptr};
+    REPLACE(ssh_add_channel_callbacks, [&callbacks](ssh_channel, ssh_channel_callbacks cb) {
+        callbacks = cb;
+        return SSH_OK;
+    });
+    REPLACE(ssh_event_dopoll, [&callbacks](auto...) {
+        EXPECT_THAT(callbacks->channel_data_function, IsNull());
+        return SSH_OK;
+    });
+
+    auto proc = session.exec("something");
+    EXPECT_FALSE(proc.exit_recognized(std::chrono::milliseconds(1)));
+}
+
 TEST_F(SSHProcess, exit_code_times_out)
 {
     REPLACE(ssh_event_dopoll, [](ssh_event, int timeout) {
@@ -70,6 +110,60 @@ TEST_F(SSHProcess, exit_code_times_out)
     EXPECT_THROW(proc.exit_code(std::chrono::milliseconds(1)), std::runtime_error);
 }
 
+TEST_F(SSHProcess, waitForOutputHandsOverOutputAsItArrives)
+{
+    ssh_channel_callbacks callbacks{nullptr};
+    REPLACE(ssh_add_channel_callbacks, [&callbacks](ssh_channel, ssh_channel_callbacks cb) {
+        callbacks = cb;
+        return SSH_OK;
+    });
+
+    std::string pending_out, pending_err;
+    auto exited = false;
+    REPLACE(ssh_event_dopoll, [&callbacks, &pending_out, &pending_err, &exited](auto...) {
+        if (!pending_out.empty())
+            callbacks->channel_data_function(nullptr, nullptr, pending_out.data(), pending_out.size(), 0,
+                                             callbacks->userdata);
+        if (!pending_err.empty())
+            callbacks->channel_data_function(nullptr, nullptr, pending_err.data(), pending_err.size(), 1,
+                                             callbacks->userdata);
+        if (exited)
+            callbacks->channel_exit_status_function(nullptr, nullptr, 3, callbacks->userdata);
+
+        pending_out.clear();
+        pending_err.clear();
+        return SSH_OK;
+    });
+
+    auto proc = session.exec("something");
+    std::string out, err;
+
+    pending_out = "first";
+    EXPECT_FALSE(proc.wait_for_output(std::chrono::milliseconds(1), out, err));
+    EXPECT_EQ(out, "first");
+    EXPECT_EQ(err, "");
+
+    pending_err = "second";
+    exited = true;
+    EXPECT_TRUE(proc.wait_for_output(std::chrono::milliseconds(1), out, err));
+    EXPECT_EQ(out, "");
+    EXPECT_EQ(err, "second");
+    EXPECT_EQ(proc.exit_code(), 3);
+}
+
+TEST_F(SSHProcess, sendsSignalsToTheRemoteProcess)
+{
+    std::string signal;
+    REPLACE(ssh_channel_request_send_signal, [&signal](ssh_channel, const char* sig) {
+        signal = sig;
+        return SSH_OK;
+    });
+
+    auto proc = session.exec("something");
+    proc.send_signal("TERM");
+    EXPECT_EQ(signal, "TERM");
+}
+
 TEST_F(SSHProcess, specifies_stderr_correctly)
 {
     int expected_is_stderr = 0;
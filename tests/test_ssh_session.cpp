@@ -130,3 +130,28 @@ TEST_F(SSHSession, moveAssigns)
     EXPECT_EQ(ssh_session{session1}, ssh_session2);
     EXPECT_EQ(ssh_session{session2}, nullptr);
 }
+
+TEST_F(SSHSession, prefersAcceleratedCiphers)
+{
+    REPLACE(ssh_connect, [](auto...) { return SSH_OK; });
+    REPLACE(ssh_userauth_publickey, [](auto...) { return SSH_AUTH_SUCCESS; });
+
+    std::string ciphers;
+    REPLACE(ssh_options_set, [&ciphers](ssh_session, ssh_options_e type, const void* value) {
+        if (type == SSH_OPTIONS_CIPHERS_C_S)
+            ciphers = static_cast<const char*>(value);
+        return SSH_OK;
+    });
+
+    make_ssh_session();
+    EXPECT_THAT(ciphers, AnyOf(StartsWith("aes128-gcm@openssh.com,"), StartsWith("chacha20-poly1305@openssh.com,")));
+    EXPECT_THAT(ciphers, HasSubstr("aes256-ctr"));
+}
+
+TEST_F(SSHSession, transportProfileNamesRoundTrip)
+{
+    for (const auto profile : {mp::SSHTransportProfile::standard, mp::SSHTransportProfile::bulk})
+        EXPECT_EQ(mp::ssh_transport_profile_from(mp::ssh_transport_profile_name(profile)), profile);
+
+    EXPECT_EQ(mp::ssh_transport_profile_from("turbo"), std::nullopt);
+}
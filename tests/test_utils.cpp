@@ -23,6 +23,7 @@
 #include "mock_ssh.h"
 #include "mock_ssh_process_exit_status.h"
 #include "mock_ssh_test_fixture.h"
+#include "mock_utils.h"
 #include "mock_virtual_machine.h"
 #include "stub_ssh_key_provider.h"
 #include "temp_dir.h"
@@ -36,8 +37,10 @@
 
 #include <gtest/gtest-death-test.h>
 
+#include <atomic>
 #include <sstream>
 #include <string>
+#include <thread>
 
 namespace mp = multipass;
 namespace mpl = multipass::logging;
@@ -493,6 +496,22 @@ TEST(Utils, try_action_actually_times_out)
     EXPECT_TRUE(on_timeout_called);
 }
 
+TEST(Utils, try_action_backs_off_exponentially_up_to_a_second)
+{
+    auto [mock_utils_ptr, guard] = mpt::MockUtils::inject();
+    std::vector<std::chrono::milliseconds> delays;
+    EXPECT_CALL(*mock_utils_ptr, sleep_for(_)).WillRepeatedly([&delays](const auto& ms) { delays.push_back(ms); });
+
+    auto attempts = 0;
+    auto action = [&attempts] {
+        return ++attempts < 7 ? mp::utils::TimeoutAction::retry : mp::utils::TimeoutAction::done;
+    };
+    mp::utils::try_action_for([] { FAIL() << "unexpected timeout"; }, std::chrono::minutes(1), action);
+
+    using namespace std::chrono_literals;
+    EXPECT_THAT(delays, ElementsAre(50ms, 100ms, 200ms, 400ms, 800ms, 1000ms));
+}
+
 TEST(Utils, try_action_does_not_timeout)
 {
     bool on_timeout_called{false};
@@ -747,6 +766,64 @@ TEST(Utils, check_filesystem_bytes_available_returns_non_negative)
     EXPECT_GE(bytes_available, 0);
 }
 
+TEST(Utils, bounded_parallel_transform_keeps_all_results_in_order)
+{
+    const std::vector<int> input{3, 0, 1, 4, 1, 5, 9, 2, 6};
+
+    auto results = mpu::bounded_parallel_transform(input, [](int i) { return i * 2; }, 4);
+
+    EXPECT_THAT(results, ElementsAre(6, 0, 2, 8, 2, 10, 18, 4, 12));
+}
+
+TEST(Utils, bounded_parallel_transform_does_not_exceed_max_concurrency)
+{
+    constexpr auto max_concurrency = 3u;
+    const std::vector<int> input(20, 0);
+    std::atomic_int running{0}, peak{0};
+
+    mpu::bounded_parallel_transform(
+        input,
+        [&running, &peak](int) {
+            auto now_running = ++running;
+            auto old_peak = peak.load();
+            while (old_peak < now_running && !peak.compare_exchange_weak(old_peak, now_running))
+                ;
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            return --running;
+        },
+        max_concurrency);
+
+    EXPECT_GE(peak.load(), 1);
+    EXPECT_LE(peak.load(), static_cast<int>(max_concurrency));
+}
+
+TEST(Utils, bounded_parallel_transform_runs_in_calling_thread_when_sequential)
+{
+    const std::vector<int> input{1, 2, 3};
+    const auto caller = std::this_thread::get_id();
+
+    auto results = mpu::bounded_parallel_transform(input, [](int) { return std::this_thread::get_id(); }, 1);
+
+    EXPECT_THAT(results, Each(Eq(caller)));
+}
+
+TEST(Utils, bounded_parallel_transform_rethrows)
+{
+    const std::vector<int> input{1, 2, 3, 4};
+
+    MP_EXPECT_THROW_THAT(mpu::bounded_parallel_transform(
+                             input,
+                             [](int i) {
+                                 if (i == 3)
+                                     throw std::runtime_error{"three"};
+                                 return i;
+                             },
+                             2),
+                         std::runtime_error,
+                         mpt::match_what(StrEq("three")));
+}
+
 TEST(VaultUtils, copy_creates_new_file_and_returned_path_exists)
 {
     mpt::TempDir temp_dir1, temp_dir2;
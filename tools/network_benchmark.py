@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+# coding: utf-8
+
+"""Measure TCP throughput between two local instances with iperf3.
+
+Needs two running instances on the default network. iperf3 is installed in both if missing. Each run uses as many
+parallel streams as the client has vCPUs, which is what exercises the multiqueue NIC; pass --streams 1 for a
+single-queue baseline.
+"""
+
+import argparse
+import json
+import logging
+import subprocess
+import sys
+
+logger = logging.getLogger("multipass.network_benchmark")
+logger.addHandler(logging.StreamHandler())
+logger.setLevel(logging.INFO)
+
+PORT = 5201
+
+
+def multipass(*args):
+    return subprocess.run(("multipass",) + args, check=True, capture_output=True, text=True).stdout.strip()
+
+
+def instance_info(instance):
+    return json.loads(multipass("info", instance, "--format", "json"))["info"][instance]
+
+
+def ensure_iperf3(instance):
+    try:
+        multipass("exec", instance, "--", "which", "iperf3")
+    except subprocess.CalledProcessError:
+        logger.info("installing iperf3 in %s", instance)
+        multipass("exec", instance, "--", "sudo", "apt-get", "update", "-q")
+        multipass("exec", instance, "--", "sudo", "DEBIAN_FRONTEND=noninteractive", "apt-get", "install", "-yq",
+                  "iperf3")
+
+
+def run_client(client, server_ip, streams, seconds, reverse):
+    args = ["iperf3", "--client", server_ip, "--port", str(PORT), "--parallel", str(streams), "--time",
+            str(seconds), "--json"]
+    if reverse:
+        args.append("--reverse")
+
+    report = json.loads(multipass("exec", client, "--", *args))
+    return report["end"]["sum_received"]["bits_per_second"] / 1e9
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("server", help="running instance to run the iperf3 server in")
+    parser.add_argument("client", help="running instance to run the iperf3 client in")
+    parser.add_argument("--streams", type=int, help="parallel streams (default: the client's vCPU count)")
+    parser.add_argument("--time", type=int, default=10, help="seconds per measurement (default: %(default)s)")
+    parser.add_argument("--runs", type=int, default=3, help="measurements per direction (default: %(default)s)")
+    args = parser.parse_args()
+
+    server_ip = instance_info(args.server)["ipv4"][0]
+    streams = args.streams or int(instance_info(args.client)["cpu_count"])
+
+    for instance in (args.server, args.client):
+        ensure_iperf3(instance)
+
+    multipass("exec", args.server, "--", "iperf3", "--server", "--port", str(PORT), "--daemon")
+    results = []
+    try:
+        for direction, reverse in (("send", False), ("receive", True)):
+            gbps = max(run_client(args.client, server_ip, streams, args.time, reverse) for _ in range(args.runs))
+            results.append((direction, gbps))
+            logger.info("%s done", direction)
+    finally:
+        multipass("exec", args.server, "--", "pkill", "-x", "iperf3")
+
+    print("{:<10}{:>10}{:>12}".format("direction", "streams", "Gbit/s"))
+    for direction, gbps in results:
+        print("{:<10}{:>10}{:>12.2f}".format(direction, streams, gbps))
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+# coding: utf-8
+
+"""Time how long it takes to start a batch of instances until all of them have an address.
+
+Needs existing instances on the default network. They are stopped before each run and started together, so the
+measurement covers tap device setup for the whole batch, guest boot and DHCP. Compare results across daemon builds
+to see the effect of changes to network bring-up.
+"""
+
+import argparse
+import json
+import logging
+import statistics
+import subprocess
+import sys
+import time
+
+logger = logging.getLogger("multipass.network_bringup_benchmark")
+logger.addHandler(logging.StreamHandler())
+logger.setLevel(logging.INFO)
+
+
+def multipass(*args):
+    return subprocess.run(("multipass",) + args, check=True, capture_output=True, text=True).stdout.strip()
+
+
+def all_have_addresses(instances):
+    info = json.loads(multipass("info", *instances, "--format", "json"))["info"]
+    return all(info[instance]["ipv4"] for instance in instances)
+
+
+def timed_start(instances, timeout):
+    multipass("stop", *instances)
+
+    start = time.monotonic()
+    multipass("start", *instances)
+    while not all_have_addresses(instances):
+        if time.monotonic() - start > timeout:
+            raise TimeoutError("instances did not get addresses in {}s".format(timeout))
+        time.sleep(0.1)
+
+    return time.monotonic() - start
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("instances", nargs="+", help="instances to start together")
+    parser.add_argument("--runs", type=int, default=5, help="measurements to take (default: %(default)s)")
+    parser.add_argument("--timeout", type=int, default=300, help="seconds to wait per run (default: %(default)s)")
+    args = parser.parse_args()
+
+    durations = []
+    for run in range(args.runs):
+        durations.append(timed_start(args.instances, args.timeout))
+        logger.info("run %d: %.2fs", run + 1, durations[-1])
+
+    print("{:<12}{:>10}{:>10}{:>10}".format("instances", "min s", "median s", "max s"))
+    print("{:<12}{:>10.2f}{:>10.2f}{:>10.2f}".format(len(args.instances), min(durations),
+                                                     statistics.median(durations), max(durations)))
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+# coding: utf-8
+
+"""Compare `multipass transfer` throughput for each `local.ssh-profile`.
+
+Needs a running instance and permission to change daemon settings. A random payload is pushed to and pulled from the
+instance with each profile. The original profile is restored at the end.
+"""
+
+import argparse
+import logging
+import os
+import pathlib
+import subprocess
+import sys
+import tempfile
+import time
+
+logger = logging.getLogger("multipass.ssh_profile_benchmark")
+logger.addHandler(logging.StreamHandler())
+logger.setLevel(logging.INFO)
+
+PROFILES = ("default", "bulk")
+SETTING = "local.ssh-profile"
+CHUNK = 1 << 20
+
+
+def multipass(*args):
+    return subprocess.run(("multipass",) + args, check=True, capture_output=True, text=True).stdout.strip()
+
+
+def wait_for_daemon(timeout=60):
+    # the daemon restarts on settings changes
+    deadline = time.monotonic() + timeout
+    while True:
+        try:
+            multipass("version")
+            return
+        except subprocess.CalledProcessError:
+            if time.monotonic() > deadline:
+                raise
+            time.sleep(0.5)
+
+
+def write_payload(path, size_mib):
+    with open(path, "wb") as f:
+        for _ in range(size_mib):
+            f.write(os.urandom(CHUNK))
+
+
+def timed_transfer(source, target):
+    start = time.monotonic()
+    multipass("transfer", source, target)
+    return time.monotonic() - start
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("instance", help="running instance to transfer to and from")
+    parser.add_argument("--size", type=int, default=256, help="payload size in MiB (default: %(default)s)")
+    parser.add_argument("--runs", type=int, default=3, help="transfers per measurement (default: %(default)s)")
+    args = parser.parse_args()
+
+    original_profile = multipass("get", SETTING)
+    remote = "{}:/tmp/ssh-profile-benchmark".format(args.instance)
+    results = []
+
+    with tempfile.TemporaryDirectory() as tmp:
+        payload = str(pathlib.Path(tmp) / "payload")
+        write_payload(payload, args.size)
+        pulled = str(pathlib.Path(tmp) / "pulled")
+
+        try:
+            for profile in PROFILES:
+                multipass("set", "{}={}".format(SETTING, profile))
+                wait_for_daemon()
+
+                push = min(timed_transfer(payload, remote) for _ in range(args.runs))
+                pull = min(timed_transfer(remote, pulled) for _ in range(args.runs))
+                results.append((profile, args.size / push, args.size / pull))
+                logger.info("%s done", profile)
+        finally:
+            multipass("set", "{}={}".format(SETTING, original_profile))
+            wait_for_daemon()
+            multipass("exec", args.instance, "--", "rm", "-f", "/tmp/ssh-profile-benchmark")
+
+    print("{:<12}{:>14}{:>14}".format("profile", "push MiB/s", "pull MiB/s"))
+    for profile, push, pull in results:
+        print("{:<12}{:>14.1f}{:>14.1f}".format(profile, push, pull))
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())